@@ -7,6 +7,7 @@
 #include "EquivalenceChecker.hpp"
 #include "ImprovedDDEquivalenceChecker.hpp"
 #include "SimulationBasedEquivalenceChecker.hpp"
+#include "StabilizerEquivalenceChecker.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -144,8 +145,6 @@ size_t getCurrentRSS()
 
 
 std::ofstream outFile;
-double fid = 0;
-bool isFid;
 
 void signalHandler(int signum) 
 {
@@ -170,22 +169,52 @@ void show_usage(const std::string& name) {
     std::cerr << "  naive                                                                        " << std::endl;
     std::cerr << "  proportional (default)                                                       " << std::endl;
     std::cerr << "  lookahead                                                                    " << std::endl;
+    std::cerr << "  beamlookahead                                                                " << std::endl;
+    std::cerr << "  sizefeedback                                                                 " << std::endl;
+    std::cerr << "  commutation                                                                  " << std::endl;
     std::cerr << "  simulation (using 'classical', 'localquantum', or 'globalquantum' stimuli)   " << std::endl;
     std::cerr << "  compilationflow                                                              " << std::endl;
+    std::cerr << "  stabilizer (Clifford circuits, falls back to the proportional strategy)       " << std::endl;
     std::cerr << "Result Options:                                                                                               " << std::endl;
     std::cerr << "  --ps:                                   Print statistics                                                    " << std::endl;
     std::cerr << "  --csv:                                  Print results as csv string                                         " << std::endl;
     std::cerr << "  --storeCEXinput:                        Store counterexample input state vector (for simulation method)     " << std::endl;
     std::cerr << "  --storeCEXoutput:                       Store resulting counterexample state vectors (for simulation method)" << std::endl;
+    std::cerr << "  --estimateFidelity:                     Estimate the average fidelity (for simulation method)               " << std::endl;
+    std::cerr << "  --concurrentSimulation:                 Simulate both circuits concurrently (for simulation method)         " << std::endl;
+    std::cerr << "  --cacheGateDDs:                         Reuse the DDs of applied gates across stimuli (for simulation method)" << std::endl;
+    std::cerr << "  --guidedStimuli:                        Guide stimuli by the differences of both circuits (for simulation method)" << std::endl;
+    std::cerr << "  --adaptiveStimuli:                      Choose stimuli types adaptively and stop at the requested confidence (for simulation method)" << std::endl;
+    std::cerr << "  --simulationCache dir:                  Persist simulation outputs of the first circuit in dir (for simulation method)" << std::endl;
     std::cerr << "Verification Parameters:                                                                          " << std::endl;
     std::cerr << "  --tol e (default 1e-13):                Numerical tolerance used during computation             " << std::endl;
+    std::cerr << "  --nthreads t (default 1):               Number of threads for parallelizable parts of the check " << std::endl;
     std::cerr << "  --nsims r (default 16):                 Number of simulations to conduct (for simulation method)" << std::endl;
     std::cerr << "  --fid F (default 0.999):                Fidelity limit for comparison (for simulation method)   " << std::endl;
     std::cerr << "  --stimuliType s (default 'classical'):  Type of stimuli to use (for simulation method)          " << std::endl;
+    std::cerr << "  --confidence c (default 0.999):         Assumed confidence of equivalence to reach with adaptive stimuli" << std::endl;
+    std::cerr << "  --backend b (default 'dd'):             Simulate with 'dd', 'dense' or 'adaptive' states (for simulation method)" << std::endl;
+    std::cerr << "  --denseThreshold f (default 1.0):       Memory fraction of a dense state triggering the switch ('adaptive' backend)" << std::endl;
+    std::cerr << "  --gc p (default 'pergate'):             Collect garbage 'pergate', at a 'threshold', near a 'memory' budget, or every 'interval' gates" << std::endl;
+    std::cerr << "  --gcThreshold n (default 2^20):         Unique table nodes triggering a collection ('threshold' policy)" << std::endl;
+    std::cerr << "  --gcMemoryBudget b (default 2^30):      Memory budget in bytes ('memory' policy)                " << std::endl;
+    std::cerr << "  --gcInterval n (default 64):            Gates between collections ('interval' policy)           " << std::endl;
+    std::cerr << "  --maxActiveNodes n (default 0):         Give up (no information) once n nodes are alive (0 = unlimited)" << std::endl;
+    std::cerr << "  --maxResidentMemory b (default 0):      Give up (no information) once b bytes are resident (0 = unlimited)" << std::endl;
+    std::cerr << "  --approximate b (default 0):            Prune simulated states exceeding b nodes (for simulation method)" << std::endl;
+    std::cerr << "  --globalStimuliDepth d (default log2 n): Random Clifford layers of global quantum stimuli       " << std::endl;
+    std::cerr << "  --heuristicAbortInterval n (default 0): Sample intermediate fidelity every n gates (G -> I <- G')" << std::endl;
+    std::cerr << "  --heuristicAbortNodeStep m (default 0): Sample intermediate fidelity every m nodes (G -> I <- G')" << std::endl;
+    std::cerr << "  --heuristicAbortThreshold F (def. 0.9): Heuristically abort once a sample falls below F (G -> I <- G')" << std::endl;
+    std::cerr << "  --lookaheadDepth k (default 4):         Applications planned ahead (for beamlookahead method)   " << std::endl;
+    std::cerr << "  --beamWidth w (default 4):              Branches kept while planning (for beamlookahead method) " << std::endl;
+    std::cerr << "  --maxImbalance f (default 4.0):         Max. deviation from the gate count ratio (for sizefeedback method)" << std::endl;
     std::cerr << "Optimization Options:                                                                             " << std::endl;
     std::cerr << "  --swapReconstruction:                   reconstruct SWAP operations                             " << std::endl;
     std::cerr << "  --singleQubitGateFusion:                fuse consecutive single qubit gates                     " << std::endl;
     std::cerr << "  --removeDiagonalGatesBeforeMeasure:     remove diagonal gates before measurements               " << std::endl;
+    std::cerr << "  --cancelMiterGates:                     cancel inverse gates and merge rotations across both circuits" << std::endl;
+    std::cerr << "  --stripCommonGates:                     strip the common prefix and suffix of both circuits      " << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -208,11 +237,8 @@ int main(int argc, char** argv) {
     outFile.open(argv[3], std::ios::app);
     signal(SIGTERM, signalHandler);
 
-    std::string isFid_str = argv[4];
-    if (isFid_str == "-f") isFid = 1;
-    else isFid = 0;
-
     ec::Configuration config{};
+    config.computeFidelity = (std::string(argv[4]) == "-f");
 
     // parse configuration options
     if (argc >= 6) {
@@ -235,6 +261,20 @@ int main(int argc, char** argv) {
                     show_usage(argv[0]);
                     return 1;
                 }
+            } else if (cmd == "--nthreads") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.nthreads = std::stoull(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
             } else if (cmd == "--nsims") {
                 ++i;
                 if (i >= argc) {
@@ -270,6 +310,72 @@ int main(int argc, char** argv) {
                     show_usage(argv[0]);
                     return 1;
                 }
+            } else if (cmd == "--heuristicabortinterval" || cmd == "--heuristicabortnodestep") {
+                const bool interval = (cmd == "--heuristicabortinterval");
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    if (interval) {
+                        config.heuristicAbortInterval = std::stoull(cmd);
+                    } else {
+                        config.heuristicAbortNodeStep = std::stoull(cmd);
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--lookaheaddepth" || cmd == "--beamwidth") {
+                const bool depth = (cmd == "--lookaheaddepth");
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    if (depth) {
+                        config.lookaheadDepth = std::stoull(cmd);
+                    } else {
+                        config.lookaheadBeamWidth = std::stoull(cmd);
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--maximbalance") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.sizeFeedbackMaxImbalance = std::stod(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--heuristicabortthreshold") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.heuristicAbortThreshold = std::stod(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
             } else if (cmd == "--method") {
                 ++i;
                 if (i >= argc) {
@@ -291,11 +397,22 @@ int main(int argc, char** argv) {
                 } else if (cmd == "lookahead") {
                     config.method   = ec::Method::G_I_Gp;
                     config.strategy = ec::Strategy::Lookahead;
+                } else if (cmd == "beamlookahead") {
+                    config.method   = ec::Method::G_I_Gp;
+                    config.strategy = ec::Strategy::BeamLookahead;
+                } else if (cmd == "sizefeedback") {
+                    config.method   = ec::Method::G_I_Gp;
+                    config.strategy = ec::Strategy::SizeFeedback;
+                } else if (cmd == "commutation") {
+                    config.method   = ec::Method::G_I_Gp;
+                    config.strategy = ec::Strategy::Commutation;
                 } else if (cmd == "compilationflow") {
                     config.method   = ec::Method::G_I_Gp;
                     config.strategy = ec::Strategy::CompilationFlow;
                 } else if (cmd == "simulation") {
                     config.method = ec::Method::Simulation;
+                } else if (cmd == "stabilizer") {
+                    config.method = ec::Method::Stabilizer;
                 } else {
                     show_usage(argv[0]);
                     return 1;
@@ -319,6 +436,167 @@ int main(int argc, char** argv) {
                     show_usage(argv[0]);
                     return 1;
                 }
+            } else if (cmd == "--backend") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                std::transform(cmd.begin(), cmd.end(), cmd.begin(), [](unsigned char c) { return ::tolower(c); });
+
+                if (cmd == "dd") {
+                    config.simulationBackend = ec::SimulationBackend::DecisionDiagram;
+                } else if (cmd == "dense") {
+                    config.simulationBackend = ec::SimulationBackend::Dense;
+                } else if (cmd == "adaptive") {
+                    config.simulationBackend = ec::SimulationBackend::Adaptive;
+                } else {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--densethreshold") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.denseSwitchThreshold = std::stod(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--gc") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                std::transform(cmd.begin(), cmd.end(), cmd.begin(), [](unsigned char c) { return ::tolower(c); });
+
+                if (cmd == "pergate") {
+                    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::PerGate;
+                } else if (cmd == "threshold") {
+                    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::NodeThreshold;
+                } else if (cmd == "memory") {
+                    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::MemoryBudget;
+                } else if (cmd == "interval") {
+                    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::Interval;
+                } else {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--gcthreshold" || cmd == "--gcmemorybudget" || cmd == "--gcinterval") {
+                const auto option = cmd;
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    const auto value = std::stoull(cmd);
+                    if (option == "--gcthreshold") {
+                        config.gcNodeThreshold = value;
+                    } else if (option == "--gcmemorybudget") {
+                        config.gcMemoryBudget = value;
+                    } else {
+                        config.gcInterval = value;
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--maxactivenodes" || cmd == "--maxresidentmemory") {
+                const auto option = cmd;
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    const auto value = std::stoull(cmd);
+                    if (option == "--maxactivenodes") {
+                        config.maxActiveNodes = value;
+                    } else {
+                        config.maxResidentMemory = value;
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--approximate") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.approximationNodeBudget = std::stoull(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--globalstimulidepth") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.globalStimuliDepth = std::stoull(cmd);
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--estimatefidelity") {
+                config.estimateFidelity = true;
+            } else if (cmd == "--cachegatedds") {
+                config.cacheGateDDs = true;
+            } else if (cmd == "--concurrentsimulation") {
+                config.concurrentCircuitSimulation = true;
+            } else if (cmd == "--guidedstimuli") {
+                config.differenceGuidedStimuli = true;
+            } else if (cmd == "--adaptivestimuli") {
+                config.adaptiveStimuli = true;
+            } else if (cmd == "--confidence") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                cmd = argv[i];
+                try {
+                    config.equivalenceConfidence = std::stod(cmd);
+                    if (config.equivalenceConfidence < 0. || config.equivalenceConfidence > 1.) {
+                        std::cerr << "Confidence should be between 0 and 1" << std::endl;
+                        show_usage(argv[0]);
+                        return 1;
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    show_usage(argv[0]);
+                    return 1;
+                }
+            } else if (cmd == "--simulationcache") {
+                ++i;
+                if (i >= argc) {
+                    show_usage(argv[0]);
+                    return 1;
+                }
+                // the directory is taken verbatim (i.e., not lowercased)
+                config.simulationCacheDirectory = argv[i];
             } else if (cmd == "--storeCEXinput") {
                 config.storeCEXinput = true;
             } else if (cmd == "--storeCEXoutput") {
@@ -329,6 +607,10 @@ int main(int argc, char** argv) {
                 config.fuseSingleQubitGates = true;
             } else if (cmd == "--removeDiagonalGatesBeforeMeasure") {
                 config.removeDiagonalGatesBeforeMeasure = true;
+            } else if (cmd == "--cancelmitergates") {
+                config.cancelMiterGates = true;
+            } else if (cmd == "--stripcommongates") {
+                config.stripCommonGates = true;
             } else {
                 show_usage(argv[0]);
                 return 1;
@@ -355,6 +637,9 @@ int main(int argc, char** argv) {
     } else if (config.method == ec::Method::Simulation) {
         ec::SimulationBasedEquivalenceChecker ec(qc1, qc2);
         results = ec.check(config);
+    } else if (config.method == ec::Method::Stabilizer) {
+        ec::StabilizerEquivalenceChecker ec(qc1, qc2);
+        results = ec.check(config);
     } else {
         ec::ImprovedDDEquivalenceChecker ec(qc1, qc2);
         results = ec.check(config);
@@ -367,7 +652,7 @@ int main(int argc, char** argv) {
     elapsedTime += (t2.tv_usec - t1.tv_usec) / 1000.0;
     runtime = elapsedTime / 1000;
 
-    if (isFid)  outFile << runtime << "," << getPeakRSS() << "," << fid << std::endl;
+    if (config.computeFidelity)  outFile << runtime << "," << getPeakRSS() << "," << results.processFidelity << std::endl;
     else outFile << runtime << "," << getPeakRSS() << std::endl;
     outFile.close();
 
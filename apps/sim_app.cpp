@@ -23,6 +23,7 @@ void show_usage(const std::string& name) {
     std::cerr << "  --toffRear X                                                add X random Toffolis to rear of 2nd circuit        " << std::endl;
     std::cerr << "  --simulation_seed sim_seed                                  seed for simulation inputs                          " << std::endl;
     std::cerr << "  --stimuliType classical | localquantum | globalquantum      type of stimuli to use                              " << std::endl;
+    std::cerr << "  --guidedStimuli                                             excite qubits affecting differences of both circuits" << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -231,6 +232,10 @@ int main(int argc, char** argv) {
                     show_usage(argv[0]);
                     return 1;
                 }
+            } else if (cmd == "--guidedstimuli") {
+                config.differenceGuidedStimuli = true;
+                resoss << "_"
+                       << "guided";
             } else {
                 show_usage(argv[0]);
                 return 1;
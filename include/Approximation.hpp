@@ -0,0 +1,28 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_APPROXIMATION_HPP
+#define QCEC_APPROXIMATION_HPP
+
+#include "Definitions.hpp"
+#include "dd/Package.hpp"
+
+#include <memory>
+
+namespace ec {
+
+    /// Approximate the vector DD e by removing the edges with the smallest contribution (i.e., the probability mass of all
+    /// paths through the edge) until the DD consists of at most maxNodes nodes. If no such DD remains, only the most probable
+    /// basis state is kept, which takes one node per qubit. The result is normalized and not reference counted. Since removing
+    /// edges projects e onto a subspace, fidelity is set to the exact fidelity |<e|result>|^2.
+    qc::VectorDD approximate(const qc::VectorDD& e, std::size_t maxNodes, std::unique_ptr<dd::Package>& package, dd::fp& fidelity);
+
+    /// Guaranteed bounds on the fidelity of two states given the fidelity of approximations of them and the angle
+    /// arccos(|<psi|phi>|) between both states and their approximations (Fubini-Study triangle inequality)
+    dd::fp fidelityLowerBound(dd::fp approximatedFidelity, dd::fp angle);
+    dd::fp fidelityUpperBound(dd::fp approximatedFidelity, dd::fp angle);
+} // namespace ec
+
+#endif //QCEC_APPROXIMATION_HPP
@@ -0,0 +1,33 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_COMMONGATESTRIPPING_HPP
+#define QCEC_COMMONGATESTRIPPING_HPP
+
+#include "QuantumComputation.hpp"
+
+#include <vector>
+
+namespace ec {
+
+    struct CommonGateStrippingStatistics {
+        std::size_t strippedPrefix  = 0U; // number of gates stripped from the beginning of each circuit
+        std::size_t strippedSuffix  = 0U; // number of gates stripped from the end of each circuit
+        std::size_t remainingGates1 = 0U;
+        std::size_t remainingGates2 = 0U;
+    };
+
+    /// Given G = B X A and G' = B Y A, the equivalence of G and G' reduces to the equivalence of X and Y. This pass strips the
+    /// longest common prefix A and suffix B (up to commuting reorderings) from both circuits. Gates are compared on the logical
+    /// qubits they act on, i.e., the initial layout for the prefix and the output permutation for the suffix. Uncontrolled SWAPs at
+    /// the beginning (end) of a circuit are absorbed into its initial layout (output permutation). A gate is only stripped from the
+    /// prefix if it does not act on ancillary qubits and only stripped from the suffix if it does not act on garbage outputs.
+    /// The parameters of two gates are considered equal if they differ by at most the given tolerance.
+    CommonGateStrippingStatistics stripCommonGates(qc::QuantumComputation& qc1, qc::Permutation& initial1, qc::Permutation& output1,
+                                                   qc::QuantumComputation& qc2, qc::Permutation& initial2, qc::Permutation& output2,
+                                                   const std::vector<bool>& ancillary, const std::vector<bool>& garbage, dd::fp tolerance);
+} // namespace ec
+
+#endif //QCEC_COMMONGATESTRIPPING_HPP
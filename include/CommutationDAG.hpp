@@ -0,0 +1,52 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_COMMUTATIONDAG_HPP
+#define QCEC_COMMUTATIONDAG_HPP
+
+#include "QuantumComputation.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ec {
+
+    /// Dependencies between the operations of a circuit. An operation only depends on the preceding operations it does not
+    /// commute with. Commutation is decided per qubit: controls and diagonal gates act on a qubit in the Z basis, uncontrolled
+    /// and controlled X-rotations act on their target in the X basis, and operations acting in the same basis on all shared
+    /// qubits commute. Everything else (multi-target, compound, and non-unitary operations) keeps its order on the qubits it acts on.
+    class CommutationDAG {
+    public:
+        enum class Role : std::uint8_t {
+            Z,
+            X,
+            General
+        };
+
+        /// The reversed DAG consumes the circuit from its end, i.e., an operation depends on the succeeding operations
+        explicit CommutationDAG(const qc::QuantumComputation& qc, bool reversed = false);
+
+        /// Indices of the operations whose predecessors have all been applied (in ascending order)
+        [[nodiscard]] const std::vector<std::size_t>& frontier() const { return front; }
+        /// Remove the operation (which has to be part of the frontier) and add all operations only depending on it
+        void markApplied(std::size_t op);
+
+        [[nodiscard]] bool        done() const { return applied == predecessors.size(); }
+        [[nodiscard]] std::size_t size() const { return predecessors.size(); }
+        [[nodiscard]] std::size_t appliedOperations() const { return applied; }
+        [[nodiscard]] const std::vector<std::size_t>& getSuccessors(std::size_t op) const { return successors.at(op); }
+
+        /// Role of the operation on each logical qubit it acts on
+        static std::vector<std::pair<dd::Qubit, Role>> roles(const qc::Operation& op, dd::QubitCount nqubits);
+
+    protected:
+        std::vector<std::vector<std::size_t>> successors{};
+        std::vector<std::size_t>              predecessors{}; // number of unapplied predecessors
+        std::vector<std::size_t>              front{};
+        std::size_t                           applied = 0U;
+    };
+} // namespace ec
+
+#endif //QCEC_COMMUTATIONDAG_HPP
@@ -0,0 +1,29 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_CROSSPACKAGE_HPP
+#define QCEC_CROSSPACKAGE_HPP
+
+#include "Definitions.hpp"
+#include "dd/Package.hpp"
+
+#include <complex>
+#include <memory>
+
+namespace ec {
+
+    /// Rebuild the vector DD e (living in an arbitrary package) in the package to.
+    /// Every node of e is visited exactly once. The returned edge is not reference counted.
+    qc::VectorDD transfer(const qc::VectorDD& e, std::unique_ptr<dd::Package>& to);
+
+    /// Inner product <x|y> of two vector DDs on the same number of qubits which may live in different packages.
+    /// The computation is memoized on pairs of nodes and never constructs the dense state vectors.
+    std::complex<dd::fp> innerProduct(const qc::VectorDD& x, const qc::VectorDD& y);
+
+    /// Fidelity |<x|y>|^2 of two vector DDs which may live in different packages
+    dd::fp fidelity(const qc::VectorDD& x, const qc::VectorDD& y);
+} // namespace ec
+
+#endif //QCEC_CROSSPACKAGE_HPP
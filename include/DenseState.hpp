@@ -0,0 +1,80 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_DENSESTATE_HPP
+#define QCEC_DENSESTATE_HPP
+
+#include "Definitions.hpp"
+#include "QuantumComputation.hpp"
+#include "dd/Package.hpp"
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ec {
+
+    /// State vector of 2^n amplitudes stored as separate arrays of real and imaginary parts.
+    /// All gate kernels sweep over contiguous runs of amplitudes (which the compiler vectorizes for the host's
+    /// instruction set) and split large sweeps across a persistent pool of threads. Every gate is applied in a sweep
+    /// of its own, i.e., consecutive gates are not blocked to apply several of them while a part of the state is cached.
+    class DenseState {
+    public:
+        using Matrix = std::vector<std::complex<dd::fp>>;
+        /// Matrices of the operations of a circuit, keyed by the address of the operation
+        using MatrixCache = std::unordered_map<const qc::Operation*, Matrix>;
+
+        /// The |0...0> state on nqubits qubits. nthreads = 0 uses all hardware threads for large states.
+        explicit DenseState(std::size_t nqubits, std::size_t nthreads = 0U);
+
+        /// Expand the vector DD (on nqubits qubits) into a dense state
+        static DenseState fromVectorDD(const qc::VectorDD& e, std::size_t nqubits, std::size_t nthreads = 0U);
+        /// Build the vector DD of the state in the given package. The returned edge is not reference counted.
+        [[nodiscard]] qc::VectorDD toVectorDD(std::unique_ptr<dd::Package>& dd) const;
+        [[nodiscard]] dd::CVec     getVector() const;
+
+        /// Apply the operation whose qubits are mapped to the qubits of the state by the permutation.
+        /// Like for DDs, uncontrolled SWAPs only update the permutation. The matrix of the operation is taken from the
+        /// given cache (see addGateMatrices) and only computed if it is missing.
+        void apply(const qc::Operation& op, qc::Permutation& permutation, const MatrixCache* matrices = nullptr);
+        /// Apply the 2^k x 2^k matrix (row-major, the i-th target corresponds to bit i of the row and column index) to the
+        /// targets of all basis states whose control qubits are set (or unset for negative controls)
+        void apply(const Matrix& matrix, const std::vector<std::size_t>& targets, const std::vector<std::size_t>& positive = {}, const std::vector<std::size_t>& negative = {});
+        /// Swap two qubits of the state
+        void swap(std::size_t q0, std::size_t q1);
+
+        /// Permute the qubits of the state such that the permutation from is turned into to (see QuantumComputation::changePermutation)
+        void changePermutation(qc::Permutation& from, const qc::Permutation& to);
+        /// Sum up the amplitudes of both values of every garbage qubit (see dd::Package::reduceGarbage)
+        void reduceGarbage(const std::vector<bool>& garbage);
+
+        [[nodiscard]] std::complex<dd::fp> innerProduct(const DenseState& other) const;
+        [[nodiscard]] dd::fp               fidelity(const DenseState& other) const;
+
+        [[nodiscard]] std::size_t          getNqubits() const { return nqubits; }
+        [[nodiscard]] std::size_t          size() const { return re.size(); }
+        [[nodiscard]] std::complex<dd::fp> amplitude(std::size_t i) const { return {re[i], im[i]}; }
+        /// Memory occupied by the amplitudes in bytes
+        [[nodiscard]] std::size_t memory() const { return 2U * re.size() * sizeof(dd::fp); }
+
+        /// Dense matrix of the operation (ignoring its controls) with the i-th target corresponding to bit i
+        static Matrix gateMatrix(const qc::Operation& op);
+        /// Compute the matrices of the operation (or of all operations of a compound operation) applied by apply
+        static void addGateMatrices(const qc::Operation& op, MatrixCache& matrices);
+
+        /// Largest number of qubits of a dense state (2^34 amplitudes occupy 256 GiB)
+        static constexpr std::size_t MAX_QUBITS = 34U;
+
+    protected:
+        std::size_t         nqubits  = 0U;
+        std::size_t         nthreads = 1U;
+        std::vector<dd::fp> re{};
+        std::vector<dd::fp> im{};
+    };
+} // namespace ec
+
+#endif //QCEC_DENSESTATE_HPP
@@ -7,26 +7,74 @@
 #define QUANTUMCIRCUITEQUIVALENCECHECKING_EQUIVALENCECHECKER_HPP
 
 #include "CircuitOptimizer.hpp"
+#include "CommonGateStripping.hpp"
 #include "EquivalenceCheckingResults.hpp"
+#include "MiterCancellation.hpp"
 #include "QuantumComputation.hpp"
 
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ec {
     enum Direction : bool { LEFT  = true,
                             RIGHT = false };
 
     struct Configuration {
+        // fixed instead of the current tolerance of the package, which is changed by every check (see ToleranceGuard)
+        static constexpr dd::fp DEFAULT_TOLERANCE = 1e-13;
+
         ec::Method   method    = ec::Method::G_I_Gp;
         ec::Strategy strategy  = ec::Strategy::Proportional;
-        dd::fp       tolerance = dd::ComplexTable<>::tolerance();
+        dd::fp       tolerance = DEFAULT_TOLERANCE;
+        std::size_t  nthreads  = 1;
+        // keep the DDs of applied gates (and their inverses) for reuse in subsequent simulations and checks. Only pays off if
+        // gates are applied repeatedly (e.g., for many stimuli), since the cached DDs stay alive for the lifetime of the checker
+        bool cacheGateDDs = false;
+        // when to collect garbage in the DD package after applying a gate: after every gate (the package only collects once
+        // its tables reach their internal limit), once the unique tables hold gcNodeThreshold nodes, once their nodes occupy
+        // 90% of gcMemoryBudget bytes, or every gcInterval gates
+        GarbageCollectionPolicy garbageCollectionPolicy = GarbageCollectionPolicy::PerGate;
+        std::size_t             gcNodeThreshold         = std::size_t{1} << 20U;
+        std::size_t             gcMemoryBudget          = std::size_t{1} << 30U;
+        std::size_t             gcInterval              = 64;
+        // hard limits on the active DD nodes and the resident memory (in bytes) of the process (0 disables a limit). Once a
+        // limit is exceeded, the check stops and reports no information together with the statistics gathered so far.
+        std::size_t maxActiveNodes    = 0;
+        std::size_t maxResidentMemory = 0;
+
+        // configuration options for G -> I <- G' equivalence checker
+        bool computeFidelity = false;
+        // heuristic abort based on the process fidelity of the intermediate result (off by default). A sample is taken every
+        // heuristicAbortInterval applied gates and whenever the result DD grows past another multiple of
+        // heuristicAbortNodeStep nodes (0 disables the respective trigger). The check is aborted as soon as
+        // a sample falls below heuristicAbortThreshold. Note that a low sample does not prove that the circuits differ:
+        // unless both circuits have consumed matching prefixes, the intermediate result of equivalent circuits may be far
+        // from the identity (e.g., midway through the proportional or lookahead strategy).
+        std::size_t heuristicAbortInterval  = 0;
+        std::size_t heuristicAbortNodeStep  = 0;
+        double      heuristicAbortThreshold = 0.9;
+        // beam lookahead strategy: plan lookaheadDepth gate applications ahead while keeping the lookaheadBeamWidth most
+        // promising branches (scored by a DD size predictor instead of actual multiplications)
+        std::size_t lookaheadDepth     = 4;
+        std::size_t lookaheadBeamWidth = 4;
+        // size feedback strategy: the ratio of applications from both sides starts at the gate count ratio and may deviate
+        // from it by at most a factor of sizeFeedbackMaxImbalance while it follows the growth of the DD
+        double sizeFeedbackMaxImbalance = 4.;
 
         // configuration options for optimizations
         bool fuseSingleQubitGates             = true;
         bool reconstructSWAPs                 = true;
         bool removeDiagonalGatesBeforeMeasure = false;
+        // cancel inverse gates, merge rotations, and remove identities in the miter G G'^-1 before constructing any DD
+        bool cancelMiterGates = false;
+        // strip the longest common prefix and suffix (up to commuting gates) of both circuits before constructing any DD
+        bool stripCommonGates = false;
 
         // configuration options for PowerOfSimulation equivalence checker
         double      fidelity_limit = 0.999;
@@ -34,27 +82,134 @@ namespace ec {
         StimuliType stimuliType    = ec::StimuliType::Classical;
         bool        storeCEXinput  = false;
         bool        storeCEXoutput = false;
+        // number of random Clifford layers used to sample global quantum stimuli (0 chooses log2(n) layers)
+        std::size_t globalStimuliDepth = 0;
+        // representation of the states during simulation. Dense state vectors (limited to 34 qubits) pay off for highly
+        // entangled states of up to about 30 qubits. The adaptive backend starts with DDs and switches to a dense state
+        // once the active vector DD nodes occupy more than denseSwitchThreshold times the memory of a dense state.
+        SimulationBackend simulationBackend    = SimulationBackend::DecisionDiagram;
+        double            denseSwitchThreshold = 1.;
+        // approximate simulation: whenever the state of a circuit exceeds this many nodes, the edges contributing the least
+        // are pruned (0 disables the approximation). The decision accounts for the fidelity lost on both sides.
+        std::size_t approximationNodeBudget = 0;
+        // simulate both circuits on separate threads and DD packages (for every stimulus)
+        bool concurrentCircuitSimulation = false;
+        // bias classical and local quantum stimuli towards the qubits affecting structural differences of the circuits
+        bool differenceGuidedStimuli = false;
+        // persist the outputs of the first circuit for every stimulus in this directory (empty disables the cache).
+        // Once the entries exceed simulationCacheSize bytes, the least recently used ones are evicted.
+        std::string    simulationCacheDirectory{};
+        std::uintmax_t simulationCacheSize = 256U * 1024U * 1024U;
+
+        // adaptive simulation: the stimuli type is chosen for every simulation and the check stops as soon as equivalence is
+        // suggested with the requested confidence (max_sims remains an upper bound). The detection probabilities are the
+        // assumed chances of a single stimulus of the respective type to expose a non-equivalence. They are not estimated from
+        // the simulations, so the confidence is only as good as these assumptions. The defaults are conservative, i.e., the
+        // default confidence requires at least 20 simulations.
+        bool   adaptiveStimuli                   = false;
+        double equivalenceConfidence             = 0.999;
+        double classicalDetectionProbability     = 0.1;
+        double localQuantumDetectionProbability  = 0.2;
+        double globalQuantumDetectionProbability = 0.3;
+
+        // configuration options for Monte-Carlo fidelity estimation (simulation method)
+        bool        estimateFidelity   = false;
+        double      fidelityConfidence = 0.95; // confidence level of the reported interval (the error probability is spent across all looks of the stopping rule, delta / (n (n + 1)) at the n-th sample)
+        double      fidelityCIWidth    = 0.01; // stop once the confidence interval is narrower than this
+        std::size_t fidelityMinSims    = 8;    // minimum number of samples before the stopping rule applies
 
         [[nodiscard]] nlohmann::json json() const {
             nlohmann::json config{};
             config["method"] = ec::toString(method);
-            if (method == ec::Method::G_I_Gp) {
-                config["strategy"] = ec::toString(strategy);
+            if (method == ec::Method::G_I_Gp || method == ec::Method::Stabilizer) {
+                config["strategy"]         = ec::toString(strategy);
+                config["compute fidelity"] = computeFidelity;
+                if (heuristicAbortInterval > 0 || heuristicAbortNodeStep > 0) {
+                    config["heuristic abort"] = {};
+                    auto& heuristic           = config["heuristic abort"];
+                    heuristic["interval"]     = heuristicAbortInterval;
+                    heuristic["node step"]    = heuristicAbortNodeStep;
+                    heuristic["threshold"]    = heuristicAbortThreshold;
+                }
+                if (strategy == ec::Strategy::BeamLookahead) {
+                    config["lookahead"]     = {};
+                    auto& lookahead         = config["lookahead"];
+                    lookahead["depth"]      = lookaheadDepth;
+                    lookahead["beam width"] = lookaheadBeamWidth;
+                }
+                if (strategy == ec::Strategy::SizeFeedback) {
+                    config["size feedback max imbalance"] = sizeFeedbackMaxImbalance;
+                }
             }
             config["tolerance"]                                   = tolerance;
+            config["threads"]                                     = nthreads;
+            config["cache gate dds"]                              = cacheGateDDs;
+            if (maxActiveNodes > 0 || maxResidentMemory > 0) {
+                config["limits"]              = {};
+                auto& limits                  = config["limits"];
+                limits["max active nodes"]    = maxActiveNodes;
+                limits["max resident memory"] = maxResidentMemory;
+            }
+            config["garbage collection"]                          = {};
+            auto& gc                                              = config["garbage collection"];
+            gc["policy"]                                          = ec::toString(garbageCollectionPolicy);
+            if (garbageCollectionPolicy == GarbageCollectionPolicy::NodeThreshold) {
+                gc["node threshold"] = gcNodeThreshold;
+            } else if (garbageCollectionPolicy == GarbageCollectionPolicy::MemoryBudget) {
+                gc["memory budget"] = gcMemoryBudget;
+            } else if (garbageCollectionPolicy == GarbageCollectionPolicy::Interval) {
+                gc["interval"] = gcInterval;
+            }
             config["optimizations"]                               = {};
             auto& optimizations                                   = config["optimizations"];
             optimizations["fuse consecutive single qubit gates"]  = fuseSingleQubitGates;
             optimizations["reconstruct swaps"]                    = reconstructSWAPs;
             optimizations["remove diagonal gates before measure"] = removeDiagonalGatesBeforeMeasure;
+            optimizations["cancel miter gates"]                   = cancelMiterGates;
+            optimizations["strip common gates"]                   = stripCommonGates;
             if (method == ec::Method::Simulation) {
-                config["simulation config"]               = {};
-                auto& simulation                          = config["simulation config"];
-                simulation["fidelity limit"]              = fidelity_limit;
-                simulation["max sims"]                    = max_sims;
-                simulation["stimuli type"]                = ec::toString(stimuliType);
-                simulation["store counterexample input"]  = storeCEXinput;
-                simulation["store counterexample output"] = storeCEXoutput;
+                config["simulation config"]                 = {};
+                auto& simulation                            = config["simulation config"];
+                simulation["fidelity limit"]                = fidelity_limit;
+                simulation["max sims"]                      = max_sims;
+                simulation["stimuli type"]                  = ec::toString(stimuliType);
+                if (simulationBackend != SimulationBackend::DecisionDiagram) {
+                    simulation["backend"] = ec::toString(simulationBackend);
+                }
+                if (simulationBackend == SimulationBackend::Adaptive) {
+                    simulation["dense switch threshold"] = denseSwitchThreshold;
+                }
+                if (stimuliType == ec::StimuliType::GlobalQuantum || adaptiveStimuli) {
+                    simulation["global stimuli depth"] = globalStimuliDepth;
+                }
+                simulation["store counterexample input"]    = storeCEXinput;
+                simulation["store counterexample output"]   = storeCEXoutput;
+                simulation["concurrent circuit simulation"] = concurrentCircuitSimulation;
+                if (approximationNodeBudget > 0) {
+                    simulation["approximation node budget"] = approximationNodeBudget;
+                }
+                simulation["difference guided stimuli"]     = differenceGuidedStimuli;
+                if (!simulationCacheDirectory.empty()) {
+                    simulation["simulation cache"] = {};
+                    auto& cache                    = simulation["simulation cache"];
+                    cache["directory"]             = simulationCacheDirectory;
+                    cache["size"]                  = simulationCacheSize;
+                }
+                if (adaptiveStimuli) {
+                    simulation["adaptive stimuli"]                   = {};
+                    auto& adaptive                                   = simulation["adaptive stimuli"];
+                    adaptive["confidence"]                           = equivalenceConfidence;
+                    adaptive["classical detection probability"]      = classicalDetectionProbability;
+                    adaptive["local quantum detection probability"]  = localQuantumDetectionProbability;
+                    adaptive["global quantum detection probability"] = globalQuantumDetectionProbability;
+                }
+                if (estimateFidelity) {
+                    simulation["fidelity estimation"] = {};
+                    auto& estimation                  = simulation["fidelity estimation"];
+                    estimation["confidence"]          = fidelityConfidence;
+                    estimation["interval width"]      = fidelityCIWidth;
+                    estimation["min sims"]            = fidelityMinSims;
+                }
             }
             return config;
         }
@@ -63,6 +218,91 @@ namespace ec {
         }
     };
 
+    /// The numerical tolerance of the DD package is shared by all packages in the process.
+    /// A guard keeps the tolerance fixed for as long as it is alive. Checks using the same tolerance may run concurrently,
+    /// while a check requesting a different tolerance waits until all checks using the current one have finished.
+    /// Guards are admitted in the order they were requested (first come, first served), so a waiting check with a different
+    /// tolerance also holds back all later checks and is not starved by a stream of checks with the current tolerance.
+    /// Guards must not be nested on the same thread: an inner guard waits for the outer one (or for a check queued in between).
+    class ToleranceGuard {
+        static std::mutex              mutex;
+        static std::condition_variable released;
+        static std::size_t             active;
+        static std::size_t             next;    // ticket handed to the next guard
+        static std::size_t             serving; // ticket of the next guard to be admitted
+        static dd::fp                  current;
+
+    public:
+        explicit ToleranceGuard(dd::fp tolerance);
+        ~ToleranceGuard();
+
+        ToleranceGuard(const ToleranceGuard&) = delete;
+        ToleranceGuard& operator=(const ToleranceGuard&) = delete;
+    };
+
+    /// Schedules the garbage collections of a DD package after applying gates according to the configured policy.
+    /// Whenever the nodes still alive after a collection exceed the trigger of the node threshold policy, the trigger is raised
+    /// to twice their number in order to avoid collecting after every gate. The memory budget policy always collects at 90% of
+    /// the budget. If a collection does not bring the memory below 80% of the budget, the following collections are spaced
+    /// by an exponentially growing number of gates (at most MAX_BACKOFF) until one of them does.
+    class GarbageCollector {
+    public:
+        static constexpr std::size_t MAX_BACKOFF = 1024U;
+
+        GarbageCollector() = default;
+        explicit GarbageCollector(const Configuration& config);
+
+        /// Invoked after every applied gate
+        void collect(dd::Package& dd);
+        /// Add the statistics of another collector (e.g., of a package used by another thread)
+        void merge(const GarbageCollector& other);
+
+        std::size_t collections = 0U;
+        double      time        = 0.;
+        std::size_t reclaimed   = 0U;
+        std::size_t peakNodes   = 0U; // nodes held by the unique tables (alive or not) when a gate has been applied
+
+    protected:
+        GarbageCollectionPolicy policy  = GarbageCollectionPolicy::PerGate;
+        std::size_t             trigger = 0U; // nodes (node threshold), bytes (memory budget), or gates (interval)
+        std::size_t             minimum = 0U;
+        std::size_t             gates   = 0U;
+        std::size_t             release = 0U; // memory below which a collection resets the backoff (memory budget)
+        std::size_t             backoff = 0U; // gates between collections while above the release mark (memory budget)
+
+        [[nodiscard]] std::size_t usage(const dd::Package& dd) const;
+    };
+
+    /// Hard limits on the resources of a check. The active nodes are checked after every gate, while the resident memory of
+    /// the process (which is more expensive to query) is only checked every MEMORY_CHECK_INTERVAL gates.
+    class ResourceLimits {
+    public:
+        static constexpr std::size_t MEMORY_CHECK_INTERVAL = 64U;
+
+        ResourceLimits() = default;
+        explicit ResourceLimits(const Configuration& config);
+
+        /// Invoked after every applied gate
+        /// \return true if any limit has been exceeded (so far)
+        bool exceeded(const dd::Package& dd);
+        /// Take over the state of another instance (e.g., of a package used by another thread)
+        void merge(const ResourceLimits& other);
+
+        [[nodiscard]] bool enabled() const { return maxActiveNodes > 0U || maxResidentMemory > 0U; }
+
+        /// Resident memory of the process in bytes (0 if the platform does not report it)
+        static std::size_t residentMemory();
+
+        bool        hit                = false;
+        std::string reason             = {}; // the limit that has been exceeded
+        std::size_t peakResidentMemory = 0U;
+
+    protected:
+        std::size_t maxActiveNodes    = 0U;
+        std::size_t maxResidentMemory = 0U;
+        std::size_t gates             = 0U;
+    };
+
     class EquivalenceChecker {
     protected:
         qc::QuantumComputation& qc1;
@@ -87,6 +327,48 @@ namespace ec {
         decltype(qc1.cend())  end1;
         decltype(qc1.cend())  end2;
 
+        /// Cache of gate DDs keyed by the operation, the direction it is applied from and the (permuted) qubits it acts on.
+        /// Cached DDs hold a reference, so they survive garbage collection and are reused across simulations and checks.
+        struct GateCacheKey {
+            const qc::Operation*   op   = nullptr;
+            qc::OpType             type = qc::None;
+            Direction              dir  = LEFT;
+            std::vector<dd::Qubit> qubits{};
+
+            bool operator==(const GateCacheKey& other) const {
+                return op == other.op && type == other.type && dir == other.dir && qubits == other.qubits;
+            }
+        };
+        struct GateCacheKeyHash {
+            std::size_t operator()(const GateCacheKey& key) const;
+        };
+        std::unordered_map<GateCacheKey, qc::MatrixDD, GateCacheKeyHash> gateCache{};
+        std::vector<const qc::Operation*>                                gateCacheOps{};
+        bool                                                             useGateCache    = true;
+        std::size_t                                                      gateCacheHits   = 0U;
+        std::size_t                                                      gateCacheMisses = 0U;
+
+        /// DD of the operation (LEFT) or its inverse (RIGHT) under the given permutation, taken from the gate cache if possible
+        qc::MatrixDD getGateDD(std::unique_ptr<qc::Operation>& op, qc::Permutation& permutation, Direction dir);
+        /// Drop all cached gates whenever the operations of the circuits changed (e.g., due to optimization passes)
+        void setupGateCache(const Configuration& config);
+        /// Copy the statistics gathered by the checker (gate cache, pre-check passes) to the results
+        void storeStatistics(EquivalenceCheckingResults& results) const;
+
+        /// Garbage collection policy of the current check and the collections it has triggered
+        GarbageCollector garbageCollector{};
+        /// Hard resource limits of the current check and the number of gates of either circuit consumed when one was hit
+        ResourceLimits resourceLimits{};
+        std::size_t    limitGates1 = 0U;
+        std::size_t    limitGates2 = 0U;
+
+        /// Gates eliminated from the miter by the last run of the miter cancellation pass
+        bool                        miterCancelled = false;
+        MiterCancellationStatistics miterStatistics{};
+        /// Gates stripped from both circuits by the last run of the common gate stripping pass
+        bool                          commonGatesStripped = false;
+        CommonGateStrippingStatistics strippingStatistics{};
+
         /// Given that one circuit has more qubits than the other, the difference is assumed to arise from ancillary qubits.
         /// This function adjusts both circuits accordingly
         static void setupAncillariesAndGarbage(qc::QuantumComputation& smaller_circuit, qc::QuantumComputation& larger_circuit);
@@ -99,33 +381,34 @@ namespace ec {
         /// Run any configured optimization passes
         virtual void runPreCheckPasses(const Configuration& config);
 
+        /// Collect garbage according to the configured policy and check the resource limits after a gate has been applied
+        void afterGate() {
+            garbageCollector.collect(*dd);
+            if (resourceLimits.enabled()) {
+                resourceLimits.exceeded(*dd);
+            }
+        }
+
         /// Take operation and apply it either from the left or (inverted) from the right
         /// \param op operation to apply
         /// \param to DD to apply the operation to
         /// \param dir LEFT or RIGHT
         template<class DDType>
         void applyGate(std::unique_ptr<qc::Operation>& op, DDType& to, qc::Permutation& permutation, Direction dir = LEFT) {
-            // set appropriate qubit count to generate correct DD
-            auto nq = op->getNqubits();
-            op->setNqubits(nqubits);
-
             auto saved = to;
             if constexpr (std::is_same_v<DDType, qc::VectorDD>) {
                 // direction has no effect on state vector DDs
-                to = dd->multiply(op->getDD(dd, permutation), to);
+                to = dd->multiply(getGateDD(op, permutation, LEFT), to);
             } else {
                 if (dir == LEFT) {
-                    to = dd->multiply(op->getDD(dd, permutation), to);
+                    to = dd->multiply(getGateDD(op, permutation, LEFT), to);
                 } else {
-                    to = dd->multiply(to, op->getInverseDD(dd, permutation));
+                    to = dd->multiply(to, getGateDD(op, permutation, RIGHT));
                 }
             }
             dd->incRef(to);
             dd->decRef(saved);
-            dd->garbageCollect();
-
-            // reset qubit count
-            op->setNqubits(nq);
+            afterGate();
         }
         template<class DDType>
         void applyGate(qc::QuantumComputation& qc, decltype(qc1.begin())& opIt, DDType& to, qc::Permutation& permutation, Direction dir = LEFT) {
@@ -159,8 +442,10 @@ namespace ec {
         virtual EquivalenceCheckingResults check() { return check(Configuration{}); };
         virtual EquivalenceCheckingResults check(const Configuration& config);
 
-        static void setTolerance(dd::fp tol) { decltype(dd->cn.complexTable)::setTolerance(tol); }
-        Method      method = ec::Method::Reference;
+        /// Release all cached gate DDs
+        void clearGateCache();
+
+        Method method = ec::Method::Reference;
     };
 
 } // namespace ec
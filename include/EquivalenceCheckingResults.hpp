@@ -10,6 +10,8 @@
 #include "dd/Package.hpp"
 #include "nlohmann/json.hpp"
 
+#include <array>
+#include <complex>
 #include <iostream>
 #include <string>
 
@@ -25,14 +27,18 @@ namespace ec {
     enum class Method {
         Reference,
         G_I_Gp,
-        Simulation
+        Simulation,
+        Stabilizer
     };
 
     enum class Strategy {
         Naive,
         Proportional,
         Lookahead,
-        CompilationFlow
+        CompilationFlow,
+        BeamLookahead,
+        SizeFeedback,
+        Commutation
     };
 
     enum class StimuliType {
@@ -41,10 +47,25 @@ namespace ec {
         GlobalQuantum
     };
 
+    enum class SimulationBackend {
+        DecisionDiagram,
+        Dense,
+        Adaptive
+    };
+
+    enum class GarbageCollectionPolicy {
+        PerGate,
+        NodeThreshold,
+        MemoryBudget,
+        Interval
+    };
+
     std::string toString(const Method& method);
     std::string toString(const Equivalence& equivalence);
     std::string toString(const Strategy& method);
     std::string toString(const StimuliType& stimuliType);
+    std::string toString(const SimulationBackend& backend);
+    std::string toString(const GarbageCollectionPolicy& policy);
 
     struct EquivalenceCheckingResults {
         struct CircuitInfo {
@@ -83,6 +104,84 @@ namespace ec {
         dd::fp       fidelity = 0.0;
         qc::MatrixDD result   = qc::MatrixDD::zero;
 
+        // trace of the resulting functionality and the corresponding process fidelity |tr(U)|^2 / 4^n (G -> I <- G' scheme)
+        bool                 traceComputed   = false;
+        std::complex<dd::fp> trace           = 0.;
+        dd::fp               processFidelity = 0.;
+
+        // heuristic abort based on the sampled process fidelity of the intermediate result (G -> I <- G' scheme)
+        bool        heuristicallyAborted = false;
+        std::size_t abortGateIndex       = 0; // total number of gates consumed when the check was aborted
+        std::size_t abortGates1          = 0;
+        std::size_t abortGates2          = 0;
+        dd::fp      abortFidelity        = 0.;
+
+        // hard resource limits: the limit that has been exceeded, the number of gates of either circuit consumed by then (in
+        // the last simulation for the simulation method), and the peak resident memory sampled so far
+        bool        limitExceeded      = false;
+        std::string limitReason        = {};
+        std::size_t limitGates1        = 0;
+        std::size_t limitGates2        = 0;
+        std::size_t peakResidentMemory = 0;
+
+        // gates removed from either circuit and rotations merged by the miter cancellation pass
+        bool        miterCancelled       = false;
+        std::size_t miterRemovedGates1   = 0;
+        std::size_t miterRemovedGates2   = 0;
+        std::size_t miterMergedRotations = 0;
+
+        // gates stripped from the beginning (prefix) and end (suffix) of both circuits and the size of the reduced problem
+        bool        commonGatesStripped = false;
+        std::size_t strippedPrefix      = 0;
+        std::size_t strippedSuffix      = 0;
+        std::size_t remainingGates1     = 0;
+        std::size_t remainingGates2     = 0;
+
+        // garbage collections triggered after applying gates, the time spent on them, the number of reclaimed nodes, and the
+        // peak number of nodes held by the unique tables (alive or not)
+        std::size_t gcCollections    = 0;
+        double      gcTime           = 0.;
+        std::size_t gcReclaimedNodes = 0;
+        std::size_t gcPeakNodes      = 0;
+
+        // reuse of cached gate DDs
+        std::size_t gateCacheHits   = 0;
+        std::size_t gateCacheMisses = 0;
+
+        // outputs of the first circuit loaded from (hits) or added to (misses) the persistent simulation cache
+        std::size_t simulationCacheHits   = 0;
+        std::size_t simulationCacheMisses = 0;
+
+        // adaptive simulation: confidence of equivalence (derived from the assumed detection probabilities, not measured) and
+        // number of simulations per stimuli type (indexed by StimuliType)
+        bool                       adaptiveStimuli       = false;
+        dd::fp                     equivalenceConfidence = 0.;
+        std::array<std::size_t, 3> simsPerStimuliType{};
+
+        // approximate simulation: guaranteed bounds on the fidelity of the exact outputs of the last simulation (derived from
+        // the approximated fidelity), total number of pruning rounds, and the peak size of the approximated states
+        dd::fp      fidelityLowerBound     = 0.;
+        dd::fp      fidelityUpperBound     = 0.;
+        bool        approximated           = false;
+        std::size_t approximations         = 0;
+        std::size_t approximationPeakNodes = 0;
+
+        // adaptive simulation backend: number of simulated circuits that switched from DDs to dense states, the gate index of
+        // the first switch, the total time spent on conversions, and the peak memory of the simulated states in bytes
+        std::size_t denseSwitches       = 0;
+        std::size_t denseSwitchGate     = 0;
+        double      denseConversionTime = 0.0;
+        std::size_t peakStateMemory     = 0;
+
+        // number of qubits excited by difference-guided stimuli (simulation method)
+        std::size_t guidedQubits = 0;
+
+        // Monte-Carlo fidelity estimation (simulation method)
+        bool   fidelityEstimated = false;
+        dd::fp fidelityEstimate  = 0.;
+        dd::fp ciLow             = 0.;
+        dd::fp ciHigh            = 0.;
+
         [[nodiscard]] bool consideredEquivalent() const {
             return equivalence == Equivalence::Equivalent || equivalence == Equivalence::EquivalentUpToGlobalPhase || equivalence == Equivalence::ProbablyEquivalent;
         }
@@ -110,7 +209,7 @@ namespace ec {
         }
 
         static std::string getCSVHeader() {
-            return "filename1;nqubits1;ngates1;filename2;nqubits2;ngates2;equivalent;t_pre;t_ver;maxActive;method;strategy;nsims;stimuliType";
+            return "filename1;nqubits1;ngates1;filename2;nqubits2;ngates2;equivalent;t_pre;t_ver;maxActive;method;strategy;nsims;stimuliType;assumedConfidence";
         }
         static std::ostream& printCSVHeader(std::ostream& out = std::cout) {
             out << getCSVHeader();
@@ -6,15 +6,17 @@
 #ifndef QUANTUMCIRCUITEQUIVALENCECHECKING_IMPROVEDDDEQUIVALENCECHECKER_HPP
 #define QUANTUMCIRCUITEQUIVALENCECHECKING_IMPROVEDDDEQUIVALENCECHECKER_HPP
 
+#include "CommutationDAG.hpp"
 #include "EquivalenceChecker.hpp"
+#include "TraceEngine.hpp"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <unordered_set>
-
-extern double fid;
-extern bool isFid;
+#include <vector>
 
 namespace ec {
 
@@ -25,11 +27,36 @@ namespace ec {
         void checkProportional(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2);
         /// Look-ahead LEFT and RIGHT and choose the more promising option
         void checkLookahead(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2);
+        /// Plan several applications ahead with a beam search on predicted DD sizes and only apply the most promising branch
+        void checkBeamLookahead(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2, std::size_t depth, std::size_t beamWidth);
+        /// Alternate between LEFT and RIGHT applications with a ratio that follows the growth of the DD caused by either side
+        void checkSizeFeedback(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2, double maxImbalance);
+        /// Pick the gates of both circuits from the frontiers of their commutation DAGs, preferring gates that cancel each other
+        void checkCommutation(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2);
+
+        /// Evaluates the trace of the resulting DD (retains its memo table across checks)
+        TraceEngine traceEngine{};
+
+        /// State of the heuristic abort, which monitors the process fidelity of the intermediate result
+        struct FidelityMonitor {
+            std::size_t interval           = 0U;
+            std::size_t nodeStep           = 0U;
+            double      threshold          = 0.;
+            std::size_t appliedGates       = 0U;
+            std::size_t nextNodeCheckpoint = 0U;
+            dd::fp      fidelity           = 1.;
+            bool        aborted            = false;
+
+            [[nodiscard]] bool enabled() const { return interval > 0U || nodeStep > 0U; }
+        } fidelityMonitor{};
 
-        dd::fp * traceRecur(dd::Package::mNode * cur, std::map<dd::Package::mNode *, dd::fp *> *Node_Table);
-        dd::fp * complex2fp(const dd::Complex &c);
-        dd::fp * add(dd::fp * a, dd::fp * b);
-        dd::fp * mul(dd::fp * a, dd::fp * b);
+        void setupMonitor(const Configuration& config);
+        /// Account for an applied gate and sample the process fidelity of the intermediate result if a checkpoint is reached
+        /// \return true if the sampled fidelity dropped below the configured threshold (or a resource limit has been exceeded)
+        /// and the check shall be aborted
+        bool monitor(const qc::MatrixDD& result);
+        /// Whether the check shall be aborted due to the heuristic abort or a resource limit
+        [[nodiscard]] bool aborted() const { return fidelityMonitor.aborted || resourceLimits.hit; }
 
     protected:
         /// Create the initial matrix used for the G->I<-G' scheme.
@@ -0,0 +1,33 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_MITERCANCELLATION_HPP
+#define QCEC_MITERCANCELLATION_HPP
+
+#include "QuantumComputation.hpp"
+
+#include <vector>
+
+namespace ec {
+
+    struct MiterCancellationStatistics {
+        std::size_t removedGates1   = 0U;
+        std::size_t removedGates2   = 0U;
+        std::size_t mergedRotations = 0U;
+    };
+
+    /// Peephole optimization of the miter G G'^-1 of both circuits before any DD is constructed. The gates of both circuits
+    /// are resolved to the output qubits they end up on (accounting for the initial layouts, SWAPs, and output permutations) and
+    /// each gate is moved towards the preceding gates of the miter as long as it commutes with them. Pairs of inverse gates
+    /// cancel, rotations about the same axis are merged, and identities are removed. Gates of G and G' only cancel or merge
+    /// across the boundary of the miter if they do not act on garbage outputs. The miter (and, hence, the result of the check) is
+    /// preserved, while the individual circuits might change. Compound and non-unitary operations are left untouched.
+    /// Rotations by at most the given tolerance (after merging) are considered identities.
+    MiterCancellationStatistics cancelMiterGates(qc::QuantumComputation& qc1, const qc::Permutation& initial1, const qc::Permutation& output1,
+                                                 qc::QuantumComputation& qc2, const qc::Permutation& initial2, const qc::Permutation& output2,
+                                                 const std::vector<bool>& garbage, dd::QubitCount nqubits, dd::fp tolerance);
+} // namespace ec
+
+#endif //QCEC_MITERCANCELLATION_HPP
@@ -6,19 +6,30 @@
 #ifndef QCEC_SIMULATIONBASEDEQUIVALENCECHECKER_HPP
 #define QCEC_SIMULATIONBASEDEQUIVALENCECHECKER_HPP
 
+#include "Approximation.hpp"
 #include "CircuitOptimizer.hpp"
+#include "DenseState.hpp"
 #include "EquivalenceChecker.hpp"
-#include "algorithms/RandomCliffordCircuit.hpp"
+#include "SimulationCache.hpp"
+#include "StimulusPermutation.hpp"
+#include "StabilizerTableau.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <sstream>
-#include <unordered_set>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 #define DEBUG_MODE_SIMULATION 0
 
@@ -28,19 +39,112 @@ namespace ec {
     protected:
         std::function<std::size_t()>    stimuliGenerator;
         std::function<unsigned short()> basisStateGenerator;
-        std::unordered_set<std::size_t> stimuli;
+
+        /// the i-th classical stimulus of a check is the image of i under a freshly keyed permutation,
+        /// so all classical stimuli of a check are distinct without having to remember the ones already used
+        StimulusPermutation classicalStimuli{};
+        std::uint64_t       nextClassicalStimulus = 0U;
 
         dd::QubitCount nqubits_for_stimuli = 0;
+        /// number of random Clifford layers of global quantum stimuli
+        std::size_t globalStimuliDepth = 0U;
+        [[nodiscard]] std::size_t defaultGlobalStimuliDepth() const {
+            return static_cast<std::size_t>(std::max(1., std::round(std::log2(nqubits_for_stimuli))));
+        }
 
         std::size_t                                   seed = 0;
         std::mt19937_64                               mt;
-        std::uniform_int_distribution<std::size_t>    distribution;
         std::uniform_int_distribution<unsigned short> basisStateDistribution;
 
-        qc::VectorDD generateRandomStimulus(StimuliType type = StimuliType::Classical);
-        qc::VectorDD generateRandomClassicalStimulus();
-        qc::VectorDD generateRandomLocalQuantumStimulus();
-        qc::VectorDD generateRandomGlobalQuantumStimulus();
+        /// package and copied operations used to simulate the second circuit concurrently to the first one
+        std::unique_ptr<dd::Package>                dd2{};
+        std::vector<std::unique_ptr<qc::Operation>> ops2{};
+
+        /// matrices of the operations of both circuits (after all passes) for the dense and the adaptive backend
+        DenseState::MatrixCache denseMatrices{};
+
+        /// qubits whose excitation may expose the structural differences between both circuits
+        bool              guidedStimuli = false;
+        std::vector<bool> guidedQubits{};
+
+        /// persistent cache of the outputs of the first circuit, keyed by the hash of the circuit (after all passes)
+        std::unique_ptr<SimulationCache> simulationCache{};
+        std::uint64_t                    circuitHash1   = 0U;
+        dd::fp                           cacheTolerance = 0.;
+
+        /// approximate simulation of a single circuit
+        struct Approximation {
+            std::size_t nodeBudget = 0U; // prune the state whenever it exceeds this many nodes (0 disables the approximation)
+            dd::fp      angle      = 0.; // upper bound on the angle arccos(|<psi|phi>|) between the exact and the approximated state
+            std::size_t rounds     = 0U;
+            std::size_t peakNodes  = 0U; // including the size right after applying a gate, i.e., before the state is pruned
+        };
+        /// Prune the state (in place) to half of the node budget if it exceeds the budget and account for the fidelity lost
+        static void approximateState(qc::VectorDD& e, Approximation& approximation, std::unique_ptr<dd::Package>& package);
+        /// Record the approximations of both circuits and derive the guaranteed bounds on the fidelity of the exact outputs.
+        /// The bounds assume that only unitaries follow the pruning. Reducing garbage outputs is not norm-preserving, so no bounds
+        /// (i.e., [0, 1]) are derived for pruned states of circuits with garbage outputs.
+        void storeApproximation(EquivalenceCheckingResults& results, const Approximation& approximation1, const Approximation& approximation2) const;
+
+        /// guards the random number generation and the enumeration of classical stimuli
+        std::mutex generatorMutex;
+
+        /// Start a new sequence of distinct classical stimuli and set up the stimuli generation according to the configuration
+        void resetStimuli(const Configuration& config);
+        /// Number of distinct classical stimuli (saturating for 64 or more qubits)
+        [[nodiscard]] std::uint64_t numberOfClassicalStimuli() const {
+            return nqubits_for_stimuli >= 64 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t{1} << nqubits_for_stimuli);
+        }
+
+        /// Generate a random stimulus in the given DD package
+        qc::VectorDD generateRandomStimulus(StimuliType type, std::unique_ptr<dd::Package>& package);
+        qc::VectorDD generateRandomStimulus(StimuliType type = StimuliType::Classical) { return generateRandomStimulus(type, dd); }
+        qc::VectorDD generateRandomClassicalStimulus(std::unique_ptr<dd::Package>& package);
+        qc::VectorDD generateRandomLocalQuantumStimulus(std::unique_ptr<dd::Package>& package);
+        qc::VectorDD generateRandomGlobalQuantumStimulus(std::unique_ptr<dd::Package>& package);
+        /// Put the guided qubits in random superpositions (or flip them) and choose the other qubits according to type
+        qc::VectorDD generateGuidedStimulus(StimuliType type, std::unique_ptr<dd::Package>& package);
+        /// Match the gates of both circuits by their structure and determine the inputs within the light cone of the unmatched ones
+        void         setupGuidedStimuli(const Configuration& config, EquivalenceCheckingResults& results);
+        /// Simulate the given circuit with the stimulus and correct its output permutation and garbage qubits
+        qc::VectorDD simulate(const qc::VectorDD& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, Approximation* approximation = nullptr);
+        /// Copy the operations of the circuit (without final measurements) for the exclusive use by a single worker thread
+        std::vector<std::unique_ptr<qc::Operation>> cloneOperations(qc::QuantumComputation& qc) const;
+        /// Simulate copied operations in the given package. The simulation stops early once cancelled is set or a limit is exceeded.
+        /// If given, completed is set to whether all operations have been applied.
+        qc::VectorDD simulate(const qc::VectorDD& stimulus, const std::vector<std::unique_ptr<qc::Operation>>& ops, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, std::unique_ptr<dd::Package>& package, GarbageCollector& collector, ResourceLimits& limits, const std::atomic<bool>& cancelled, Approximation* approximation = nullptr, bool* completed = nullptr);
+        void         setupConcurrentSimulation(const Configuration& config);
+        /// Open the configured simulation cache and hash the first circuit as it is simulated
+        void         setupSimulationCache(const Configuration& config);
+        void         storeSimulationCacheStatistics(EquivalenceCheckingResults& results) const;
+        /// Simulate the first circuit with the stimulus or load its output from the simulation cache (which is bypassed by approximate simulations)
+        qc::VectorDD simulateFirstCircuit(const qc::VectorDD& stimulus, Approximation* approximation = nullptr);
+        /// Simulate both circuits on two threads in separate packages and compare the outputs across the packages
+        void         simulateConcurrentlyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config);
+        /// Compute the matrices of all operations once, so that they are reused for every stimulus
+        void         setupDenseSimulation(const Configuration& config);
+        /// Simulate the given circuit on a dense state vector and correct its output permutation and garbage qubits
+        DenseState   simulate(const DenseState& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage);
+        /// Simulate both circuits on dense state vectors (instead of DDs) and compare their outputs
+        void         simulateDenselyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config);
+        void         applyGate(qc::QuantumComputation& qc, decltype(qc1.begin())& opIt, DenseState& state, qc::Permutation& permutation);
+        using EquivalenceChecker::applyGate;
+        /// Remember how far the simulation of the given circuit got when a resource limit has been exceeded
+        void         recordLimitGates(const qc::QuantumComputation& qc, decltype(qc1.cbegin()) it);
+        /// Simulate the given circuit with DDs and continue on a dense state (returned in dense) as soon as the active vector DD
+        /// nodes occupy more memory than the configured share of a dense state. Otherwise, the (reference counted) output DD is returned.
+        qc::VectorDD simulateAdaptively(const qc::VectorDD& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, std::optional<DenseState>& dense, EquivalenceCheckingResults& results, const Configuration& config);
+        /// Simulate both circuits adaptively and compare their outputs (in dense form if any of them switched)
+        void         simulateAdaptivelyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config);
+        /// Whether the fidelity (bounds) of the last simulation show the outputs to differ
+        [[nodiscard]] bool outputsDiffer(const EquivalenceCheckingResults& results, const Configuration& config) const;
+        /// Decide on the equivalence based on the fidelity (bounds) of the last simulation. Returns whether the check is done.
+        bool         concludeSimulation(EquivalenceCheckingResults& results, const Configuration& config) const;
+        /// Reject configurations the simulation backends do not support
+        static void  checkBackend(const Configuration& config);
+        /// Simulate both circuits with the stimulus using the configured backend and store the fidelity (bounds) of their outputs
+        /// (and the counterexample if they differ) in the results. Every stimulus of every mode of the check is simulated this way.
+        void         compareWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config);
         bool         simulateWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config = Configuration{});
         void         checkWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config = Configuration{});
 
@@ -60,15 +164,46 @@ namespace ec {
             } else {
                 mt.seed(seed);
             }
-            distribution     = std::uniform_int_distribution<std::size_t>(0, static_cast<std::size_t>(std::pow(2.L, nqubits_for_stimuli) - 1));
-            stimuliGenerator = [&]() { return distribution(mt); };
+            stimuliGenerator = [&]() { return static_cast<std::size_t>(mt()); };
 
             basisStateDistribution = std::uniform_int_distribution<unsigned short>(0, 5);
             basisStateGenerator    = [&]() { return basisStateDistribution(mt); };
+            globalStimuliDepth     = defaultGlobalStimuliDepth();
         };
 
         EquivalenceCheckingResults check(const Configuration& config) override;
         EquivalenceCheckingResults check() override { return check(ec::Configuration{}); }
+        /// Simulate stimuli on config.nthreads worker threads, each with its own DD package and copies of both circuits.
+        /// The first worker to find a counterexample cancels all other workers. Every simulation of both circuits that ran to
+        /// completion is counted (even if another worker found a counterexample meanwhile), while simulations cut short are not.
+        /// Only the DD backend is supported and the simulation cache cannot be used (std::invalid_argument is thrown otherwise).
+        EquivalenceCheckingResults checkParallel(const Configuration& config);
+        /// Choose the stimuli type of every simulation adaptively and stop as soon as equivalence is suggested with the configured confidence.
+        /// With both circuits assumed to be non-equivalent with probability 1/2 a priori, the confidence after all simulations passed
+        /// is 1 / (1 + m), where m = prod_t (1 - p_t)^(n_t) is the probability that n_t stimuli of type t (each exposing a non-equivalence
+        /// with probability p_t) missed it. Every type is tried once. Afterwards, the type with the largest gain in confidence per time
+        /// is chosen, where types whose fidelities spread more (i.e., that see the circuits differ) are preferred.
+        EquivalenceCheckingResults checkAdaptive(const Configuration& config);
+        /// Estimate the average fidelity between both circuits as the mean fidelity of the outputs for random stimuli, i.e.,
+        /// the expected output fidelity over the distribution of the configured stimuli type. Global quantum stimuli are prepared
+        /// by globalStimuliDepth layers of random Clifford gates and are, hence, not uniformly distributed stabilizer states, so the
+        /// estimate is not the average gate fidelity in general. Since fidelities are bounded by [0, 1], the interval is the tighter
+        /// of the empirical Bernstein and the Hoeffding bound (each at half the error probability), which never collapses to a
+        /// single point even if all samples agree. Sampling stops once the interval is narrower than the configured width or the
+        /// maximum number of simulations has been conducted. As the interval is checked after every sample, the error probability
+        /// is spent across all of these looks (delta / (n (n + 1)) at the n-th sample), so the interval holds wherever sampling stops.
+        /// Approximate simulation would bias the estimate and is rejected.
+        EquivalenceCheckingResults estimateFidelity(const Configuration& config = Configuration{});
+        /// Check the reference circuit against each of the candidate circuits using the simulation method.
+        /// Every stimulus is simulated only once on the reference and its output is retained for the whole batch,
+        /// so the reference is simulated O(stimuli) instead of O(stimuli x candidates) times.
+        /// All candidates have to act on the same number of qubits (at most as many as the reference). One result is produced per
+        /// candidate. Candidates are checked one after another and only the package of the current one is kept alive.
+        /// The optimization passes run on the reference only once. Only the exact DD backend with random stimuli on a single
+        /// thread is supported. Passes that rewrite both circuits of a pair depending on each other (cancelling miter gates and
+        /// stripping common gates), guided or adaptive stimuli, fidelity estimation, parallel and concurrent simulation are
+        /// rejected with std::invalid_argument.
+        static std::vector<EquivalenceCheckingResults> checkCandidates(qc::QuantumComputation& reference, const std::vector<std::reference_wrapper<qc::QuantumComputation>>& candidates, const Configuration& config = Configuration{}, std::size_t seed = 0);
         EquivalenceCheckingResults checkZeroState(const Configuration& config = Configuration{});
         EquivalenceCheckingResults checkPlusState(const Configuration& config = Configuration{});
     };
@@ -0,0 +1,60 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_SIMULATIONCACHE_HPP
+#define QCEC_SIMULATIONCACHE_HPP
+
+#include "Definitions.hpp"
+#include "dd/Package.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace ec {
+
+    /// Persistent cache of simulation outputs on disk.
+    /// Every entry is a vector DD in a compact binary format, stored in a file named after the hash of the simulated circuit,
+    /// the numerical tolerance, and the stimulus. The hashes are also stored within the file and checked upon loading,
+    /// so changing the circuit or the tolerance invalidates all of its entries. Once the total size of all entries exceeds
+    /// the configured bound, the least recently used entries are evicted.
+    class SimulationCache {
+    public:
+        SimulationCache(std::filesystem::path directory, std::uintmax_t maxBytes);
+
+        /// Load the output of the circuit with the given hash for the stimulus into the package.
+        /// Returns false if there is no (valid) entry. The loaded edge is not reference counted.
+        bool load(std::uint64_t circuitHash, dd::fp tolerance, const qc::VectorDD& stimulus, std::unique_ptr<dd::Package>& package, qc::VectorDD& output);
+        /// Store the output of the circuit with the given hash for the stimulus
+        void store(std::uint64_t circuitHash, dd::fp tolerance, const qc::VectorDD& stimulus, const qc::VectorDD& output);
+
+        /// Structural hash of a vector DD (including its edge weights)
+        static std::uint64_t hash(const qc::VectorDD& e);
+        /// FNV-1a hash of arbitrary bytes (e.g., a textual description of a circuit)
+        static std::uint64_t hash(const std::string& bytes);
+
+        static void                serialize(const qc::VectorDD& e, std::ostream& os);
+        static qc::VectorDD        deserialize(std::istream& is, std::unique_ptr<dd::Package>& package);
+        [[nodiscard]] std::uintmax_t size() const;
+
+        [[nodiscard]] std::size_t hits() const { return nhits; }
+        [[nodiscard]] std::size_t misses() const { return nmisses; }
+
+        static constexpr const char* EXTENSION = ".vdd";
+
+    protected:
+        std::filesystem::path directory;
+        std::uintmax_t        maxBytes = 0U;
+        std::size_t           nhits    = 0U;
+        std::size_t           nmisses  = 0U;
+
+        [[nodiscard]] std::filesystem::path entry(std::uint64_t circuitHash, dd::fp tolerance, std::uint64_t stimulusHash) const;
+        void                                evict();
+    };
+} // namespace ec
+
+#endif //QCEC_SIMULATIONCACHE_HPP
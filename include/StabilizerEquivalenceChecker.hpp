@@ -0,0 +1,37 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_STABILIZEREQUIVALENCECHECKER_HPP
+#define QCEC_STABILIZEREQUIVALENCECHECKER_HPP
+
+#include "ImprovedDDEquivalenceChecker.hpp"
+#include "StabilizerTableau.hpp"
+
+namespace ec {
+
+    /// Decides the equivalence of Clifford circuits with stabilizer tableaus instead of decision diagrams.
+    /// Both circuits are applied to one half of n maximally entangled pairs (ancillaries start in |0>), which yields
+    /// their Choi states. The circuits are equivalent up to a global phase iff the states agree on all qubits but the
+    /// garbage outputs, i.e., iff the canonical generators of both reduced states are equal.
+    /// If either circuit contains a non-Clifford operation (after the optimization passes), the G -> I <- G' scheme is used.
+    class StabilizerEquivalenceChecker: public ImprovedDDEquivalenceChecker {
+    protected:
+        /// Whether every operation is a Clifford gate supported by the tableau (or a barrier or measurement)
+        static bool isClifford(qc::QuantumComputation& qc);
+
+        /// Tableau of the Choi state of the circuit with its output permutation corrected
+        StabilizerTableau choiState(qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& ancillary) const;
+
+    public:
+        StabilizerEquivalenceChecker(qc::QuantumComputation& qc1, qc::QuantumComputation& qc2):
+            ImprovedDDEquivalenceChecker(qc1, qc2) {}
+
+        EquivalenceCheckingResults check(const Configuration& config) override;
+        EquivalenceCheckingResults check() override { return check(Configuration{}); }
+    };
+
+} // namespace ec
+
+#endif //QCEC_STABILIZEREQUIVALENCECHECKER_HPP
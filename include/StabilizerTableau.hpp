@@ -0,0 +1,113 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_STABILIZERTABLEAU_HPP
+#define QCEC_STABILIZERTABLEAU_HPP
+
+#include "QuantumComputation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ec {
+
+    /// Stabilizer generators (Pauli strings with signs) stored column by column in bit-packed form.
+    /// Every Clifford gate acts on the columns of the qubits it is applied to and updates all generators at once using
+    /// word-wide bit operations, i.e., a gate costs O(nrows / 64). Products of generators (as required to bring them into
+    /// a canonical form) operate on row-wise copies, again a word at a time.
+    class StabilizerTableau {
+    public:
+        /// Pauli string (X and Z parts packed 64 qubits per word) with a sign
+        struct Generator {
+            std::vector<std::uint64_t> x{};
+            std::vector<std::uint64_t> z{};
+            bool                       sign = false;
+
+            bool operator==(const Generator& other) const { return sign == other.sign && x == other.x && z == other.z; }
+            bool operator!=(const Generator& other) const { return !(*this == other); }
+
+            [[nodiscard]] bool getX(std::size_t q) const { return (x[q / 64U] >> (q % 64U)) & 1U; }
+            [[nodiscard]] bool getZ(std::size_t q) const { return (z[q / 64U] >> (q % 64U)) & 1U; }
+            /// Replace this generator by its product with other (both have to commute)
+            void multiply(const Generator& other);
+        };
+
+        /// Tableau of nrows generators on nqubits qubits, all of which are the identity initially
+        StabilizerTableau(std::size_t nqubits, std::size_t nrows);
+        /// Tableau of the computational basis state |0...0>
+        static StabilizerTableau zeroState(std::size_t nqubits);
+
+        [[nodiscard]] std::size_t qubits() const { return nqubits; }
+        [[nodiscard]] std::size_t rows() const { return nrows; }
+
+        /// Set the Pauli operator (given by its X and Z bit) generator row applies to qubit q
+        void set(std::size_t row, std::size_t q, bool x, bool z);
+        void setSign(std::size_t row, bool sign);
+        [[nodiscard]] Generator generator(std::size_t row) const;
+
+        void h(std::size_t q);
+        void s(std::size_t q);
+        void sdg(std::size_t q);
+        void sx(std::size_t q);
+        void sxdg(std::size_t q);
+        void x(std::size_t q);
+        void y(std::size_t q);
+        void z(std::size_t q);
+        void cx(std::size_t control, std::size_t target);
+        void cy(std::size_t control, std::size_t target);
+        void cz(std::size_t a, std::size_t b);
+        void swap(std::size_t a, std::size_t b);
+
+        /// Whether the operation (or every constituent of a compound operation) is a Clifford gate supported by the tableau.
+        /// Rotations are supported if their angle is a multiple of pi/2. Global phases are not tracked.
+        static bool isClifford(const qc::Operation& op);
+        /// Apply the operation to the tableau qubits its (physical) qubits are mapped to by the permutation.
+        /// Like in the DD package, an uncontrolled SWAP only exchanges the corresponding entries of the permutation.
+        void apply(const qc::Operation& op, qc::Permutation& permutation);
+
+        /// Apply depth layers of uniformly random single-qubit Cliffords followed by CNOTs between randomly paired qubits
+        /// to the first nactive qubits. Every layer costs O(nactive * nrows / 64) operations, so deep (i.e., well mixing)
+        /// random stabilizer states come at virtually no cost.
+        void randomize(std::size_t nactive, std::size_t depth, std::mt19937_64& mt);
+
+        /// Vector DD of the stabilizer state described by the (nqubits independent) generators.
+        /// The DD is constructed bottom-up in a single pass without any DD multiplication: every node corresponds to the
+        /// canonical generators of a cofactor, and the relative phase of both successors follows from the generator
+        /// that flips the topmost qubit.
+        [[nodiscard]] qc::VectorDD toVectorDD(std::unique_ptr<dd::Package>& dd) const;
+
+        /// Bring the rows into reduced row echelon form with pivots in the given order of qubits (X before Z) and remove all rows
+        /// that became the identity. Returns false if -I is generated, i.e., if the rows do not describe a (non-zero) state.
+        static bool rowReduce(std::vector<Generator>& rows, const std::vector<std::size_t>& order);
+
+        /// Canonical generators of the stabilizer subgroup acting trivially on all traced qubits,
+        /// i.e., of the reduced state on the remaining qubits (if the tableau describes a stabilizer state).
+        /// The generators are brought into reduced row echelon form, so two groups are equal iff the results are equal.
+        [[nodiscard]] std::vector<Generator> reducedGenerators(const std::vector<bool>& traced) const;
+
+    protected:
+        std::size_t nqubits  = 0U;
+        std::size_t nrows    = 0U;
+        std::size_t rowWords = 0U;
+        std::size_t colWords = 0U;
+
+        // column q of the X (Z) part occupies the words [q * rowWords, (q + 1) * rowWords)
+        std::vector<std::uint64_t> xs{};
+        std::vector<std::uint64_t> zs{};
+        std::vector<std::uint64_t> signs{};
+
+        std::uint64_t* xcol(std::size_t q) { return xs.data() + q * rowWords; }
+        std::uint64_t* zcol(std::size_t q) { return zs.data() + q * rowWords; }
+
+        /// Number of quarter turns (modulo 4) if the angle is a multiple of pi/2
+        static bool quarterTurns(dd::fp angle, unsigned& turns);
+        static bool isCliffordStandardOperation(const qc::Operation& op);
+    };
+} // namespace ec
+
+#endif //QCEC_STABILIZERTABLEAU_HPP
@@ -0,0 +1,60 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_STIMULUSPERMUTATION_HPP
+#define QCEC_STIMULUSPERMUTATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ec {
+
+    /// Keyed pseudo-random permutation of the n-bit strings (for arbitrary n), realized as an unbalanced Feistel network.
+    /// The bits are split into a lower half of floor(n/2) and an upper half of ceil(n/2) bits and every round XORs one half
+    /// with a keyed hash of the other. Each round is invertible, so distinct indices always yield distinct bit strings.
+    /// Hence, the first k indices produce k distinct classical stimuli without keeping track of the ones already used,
+    /// and the indices 0, ..., 2^n - 1 enumerate every n-bit string exactly once.
+    class StimulusPermutation {
+    public:
+        explicit StimulusPermutation(std::size_t nbits = 0U, std::uint64_t key = 0U);
+
+        /// Bit string (least significant bit first) the index is mapped to. The index has to be less than size().
+        [[nodiscard]] std::vector<bool> operator()(std::uint64_t index) const;
+
+        /// Number of n-bit strings (saturating at the largest representable index count)
+        [[nodiscard]] std::uint64_t size() const {
+            return nbits >= 64U ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t{1} << nbits);
+        }
+        [[nodiscard]] std::size_t bits() const { return nbits; }
+
+    protected:
+        static constexpr std::size_t ROUNDS = 4U;
+
+        using Half = std::vector<std::uint64_t>;
+
+        std::size_t                     nbits     = 0U;
+        std::size_t                     lowerBits = 0U;
+        std::size_t                     upperBits = 0U;
+        std::array<std::uint64_t, ROUNDS> roundKeys{};
+
+        /// XOR the keyed hash of src into the (dstBits wide) half dst
+        static void round(const Half& src, Half& dst, std::size_t dstBits, std::uint64_t roundKey);
+
+        static std::uint64_t mix(std::uint64_t x) {
+            // finalizer of the SplitMix64 generator
+            x ^= x >> 30U;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27U;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31U;
+            return x;
+        }
+    };
+} // namespace ec
+
+#endif //QCEC_STIMULUSPERMUTATION_HPP
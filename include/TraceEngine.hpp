@@ -0,0 +1,82 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#ifndef QCEC_TRACEENGINE_HPP
+#define QCEC_TRACEENGINE_HPP
+
+#include "Definitions.hpp"
+#include "dd/Package.hpp"
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace ec {
+
+    /// Computes the trace of a matrix DD by a memoized traversal of its diagonal sub-DD.
+    /// All intermediate values are held by value and memoized in a flat open-addressing table keyed by the node address,
+    /// so evaluating a DD does not perform any heap allocation per node. The table keeps its capacity between calls.
+    class TraceEngine {
+    public:
+        using mNode = dd::Package::mNode;
+
+        explicit TraceEngine(std::size_t initialCapacity = 1024U);
+
+        /// Compute tr(e) for a matrix DD on nqubits qubits
+        std::complex<dd::fp> trace(const qc::MatrixDD& e, dd::QubitCount nqubits);
+
+        /// Compute tr(e) without recursion by first collecting the diagonal sub-DD level by level
+        /// and then evaluating the nodes of each level on up to nthreads threads
+        std::complex<dd::fp> traceParallel(const qc::MatrixDD& e, dd::QubitCount nqubits, std::size_t nthreads);
+
+        /// Process fidelity |tr(U)|^2 / 4^n corresponding to the trace of an n-qubit matrix U
+        static dd::fp processFidelity(const std::complex<dd::fp>& trace, dd::QubitCount nqubits);
+
+        /// Remove all memoized entries while retaining the allocated capacity
+        void clear();
+
+        [[nodiscard]] std::size_t size() const { return count; }
+        [[nodiscard]] std::size_t capacity() const { return table.size(); }
+
+    protected:
+        /// Number of nodes of a level a thread evaluates at once
+        static constexpr std::size_t PARALLEL_GRAIN = 256U;
+
+        struct Entry {
+            const mNode*         node = nullptr;
+            std::complex<dd::fp> value{};
+        };
+
+        std::vector<Entry> table{};
+        std::size_t        count = 0U;
+
+        /// Trace of the sub-matrix represented by the node p (without the weight of the incoming edge)
+        std::complex<dd::fp> nodeTrace(const mNode* p);
+
+        /// Contribution of a diagonal edge leaving a node at level parentLevel
+        std::complex<dd::fp> edgeTrace(const qc::MatrixDD& e, dd::Qubit parentLevel);
+        /// Weight the trace of the successor of a diagonal edge (including the contribution of skipped levels)
+        static std::complex<dd::fp> scale(const qc::MatrixDD& e, dd::Qubit parentLevel, const std::complex<dd::fp>& childTrace);
+        /// Evaluate a node whose diagonal successors have already been evaluated and store the result in its entry
+        void evaluate(const mNode* p);
+
+        [[nodiscard]] std::size_t slot(const mNode* p) const {
+            // Fibonacci hashing of the node address (the lower bits are always zero due to alignment)
+            const auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p) >> 4U);
+            return static_cast<std::size_t>(key * 11400714819323198485ULL) & (table.size() - 1U);
+        }
+        [[nodiscard]] std::size_t find(const mNode* p) const;
+        bool                      lookup(const mNode* p, std::complex<dd::fp>& value) const;
+        void                      insert(const mNode* p, const std::complex<dd::fp>& value);
+        bool                      emplace(const mNode* p);
+        void                      grow();
+
+        static std::complex<dd::fp> value(const dd::Complex& c) {
+            return {dd::CTEntry::val(c.r), dd::CTEntry::val(c.i)};
+        }
+    };
+} // namespace ec
+
+#endif //QCEC_TRACEENGINE_HPP
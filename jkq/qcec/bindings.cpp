@@ -6,6 +6,8 @@
 #include "CompilationFlowEquivalenceChecker.hpp"
 #include "QiskitImport.hpp"
 #include "SimulationBasedEquivalenceChecker.hpp"
+#include "StabilizerEquivalenceChecker.hpp"
+#include "pybind11/complex.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 #include "pybind11_json/pybind11_json.hpp"
@@ -57,6 +59,8 @@ ec::EquivalenceCheckingResults verify(const py::object&        circ1,
             }
         } else if (config.method == ec::Method::Simulation) {
             ec = std::make_unique<ec::SimulationBasedEquivalenceChecker>(qc1, qc2);
+        } else if (config.method == ec::Method::Stabilizer) {
+            ec = std::make_unique<ec::StabilizerEquivalenceChecker>(qc1, qc2);
         }
     } catch (std::exception const& e) {
         py::print("Could not construct equivalence checker: ", e.what());
@@ -73,6 +77,47 @@ ec::EquivalenceCheckingResults verify(const py::object&        circ1,
     return results;
 }
 
+std::vector<ec::EquivalenceCheckingResults> verify_candidates(const py::object&        reference,
+                                                             const py::list&          candidates,
+                                                             const ec::Configuration& config) {
+    qc::QuantumComputation qc1{};
+    try {
+        if (py::isinstance<py::str>(reference)) {
+            auto&& file1 = reference.cast<std::string>();
+            qc1.import(file1);
+        } else {
+            import(qc1, reference);
+        }
+    } catch (std::exception const& e) {
+        py::print("Could not import reference circuit: ", e.what());
+        return {};
+    }
+
+    std::vector<qc::QuantumComputation> qcs(candidates.size());
+    try {
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            const auto& candidate = candidates[i];
+            if (py::isinstance<py::str>(candidate)) {
+                auto&& file = candidate.cast<std::string>();
+                qcs[i].import(file);
+            } else {
+                import(qcs[i], candidate);
+            }
+        }
+    } catch (std::exception const& e) {
+        py::print("Could not import candidate circuit: ", e.what());
+        return {};
+    }
+
+    std::vector<std::reference_wrapper<qc::QuantumComputation>> refs(qcs.begin(), qcs.end());
+    try {
+        return ec::SimulationBasedEquivalenceChecker::checkCandidates(qc1, refs, config);
+    } catch (std::exception const& e) {
+        py::print("Error during equivalence check: ", e.what());
+        return {};
+    }
+}
+
 PYBIND11_MODULE(pyqcec, m) {
     m.doc() = "Python interface for the JKQ QCEC quantum circuit equivalence checking tool";
 
@@ -80,12 +125,16 @@ PYBIND11_MODULE(pyqcec, m) {
             .value("reference", ec::Method::Reference)
             .value("G_I_Gp", ec::Method::G_I_Gp)
             .value("simulation", ec::Method::Simulation)
+            .value("stabilizer", ec::Method::Stabilizer)
             .export_values();
 
     py::enum_<ec::Strategy>(m, "Strategy")
             .value("naive", ec::Strategy::Naive)
             .value("proportional", ec::Strategy::Proportional)
             .value("lookahead", ec::Strategy::Lookahead)
+            .value("beamlookahead", ec::Strategy::BeamLookahead)
+            .value("sizefeedback", ec::Strategy::SizeFeedback)
+            .value("commutation", ec::Strategy::Commutation)
             .value("compilationflow", ec::Strategy::CompilationFlow)
             .export_values();
 
@@ -95,6 +144,19 @@ PYBIND11_MODULE(pyqcec, m) {
             .value("globalquantum", ec::StimuliType::GlobalQuantum)
             .export_values();
 
+    py::enum_<ec::GarbageCollectionPolicy>(m, "GarbageCollectionPolicy")
+            .value("per_gate", ec::GarbageCollectionPolicy::PerGate)
+            .value("node_threshold", ec::GarbageCollectionPolicy::NodeThreshold)
+            .value("memory_budget", ec::GarbageCollectionPolicy::MemoryBudget)
+            .value("interval", ec::GarbageCollectionPolicy::Interval)
+            .export_values();
+
+    py::enum_<ec::SimulationBackend>(m, "SimulationBackend")
+            .value("decision_diagram", ec::SimulationBackend::DecisionDiagram)
+            .value("dense", ec::SimulationBackend::Dense)
+            .value("adaptive", ec::SimulationBackend::Adaptive)
+            .export_values();
+
     py::enum_<ec::Equivalence>(m, "Equivalence")
             .value("no_information", ec::Equivalence::NoInformation)
             .value("not_equivalent", ec::Equivalence::NotEquivalent)
@@ -121,11 +183,74 @@ PYBIND11_MODULE(pyqcec, m) {
 					- proportional (*default*)
 					- lookahead
 					- compilationflow
+					- beamlookahead
+					- sizefeedback
+					- commutation
+				)pbdoc")
+            .def_readwrite("nthreads", &ec::Configuration::nthreads,
+                           R"pbdoc(
+					Number of threads to use for parallelizable parts of the check
+				)pbdoc")
+            .def_readwrite("cache_gate_dds", &ec::Configuration::cacheGateDDs,
+                           R"pbdoc(
+					Keep the DDs of applied gates for reuse in subsequent simulations and checks
+				)pbdoc")
+            .def_readwrite("garbage_collection_policy", &ec::Configuration::garbageCollectionPolicy,
+                           R"pbdoc(
+					When to collect garbage after applying a gate (per gate, at a node threshold, near a memory budget, or at an interval)
+				)pbdoc")
+            .def_readwrite("gc_node_threshold", &ec::Configuration::gcNodeThreshold,
+                           R"pbdoc(
+					Number of unique table nodes triggering a garbage collection (node threshold policy)
+				)pbdoc")
+            .def_readwrite("gc_memory_budget", &ec::Configuration::gcMemoryBudget,
+                           R"pbdoc(
+					Memory budget in bytes of the unique table nodes (memory budget policy)
+				)pbdoc")
+            .def_readwrite("gc_interval", &ec::Configuration::gcInterval,
+                           R"pbdoc(
+					Number of gates between garbage collections (interval policy)
+				)pbdoc")
+            .def_readwrite("max_active_nodes", &ec::Configuration::maxActiveNodes,
+                           R"pbdoc(
+					Give up without information once this many nodes are alive in the DD package (0 for no limit)
+				)pbdoc")
+            .def_readwrite("max_resident_memory", &ec::Configuration::maxResidentMemory,
+                           R"pbdoc(
+					Give up without information once the process occupies this many bytes of resident memory (0 for no limit)
+				)pbdoc")
+            .def_readwrite("compute_fidelity", &ec::Configuration::computeFidelity,
+                           R"pbdoc(
+					Compute the trace and process fidelity of the resulting functionality (for G_I_Gp method)
 				)pbdoc")
             .def_readwrite("tolerance", &ec::Configuration::tolerance,
                            R"pbdoc(
 					Numerical tolerance used during computation
 				)pbdoc")
+            .def_readwrite("heuristic_abort_interval", &ec::Configuration::heuristicAbortInterval,
+                           R"pbdoc(
+					Heuristic abort: sample the process fidelity of the intermediate result every N applied gates (0 disables, for G_I_Gp method)
+				)pbdoc")
+            .def_readwrite("heuristic_abort_node_step", &ec::Configuration::heuristicAbortNodeStep,
+                           R"pbdoc(
+					Heuristic abort: sample the process fidelity of the intermediate result whenever its DD grows past another multiple of this many nodes (0 disables, for G_I_Gp method)
+				)pbdoc")
+            .def_readwrite("heuristic_abort_threshold", &ec::Configuration::heuristicAbortThreshold,
+                           R"pbdoc(
+					Heuristic abort: give up as soon as a sampled process fidelity falls below this value. Equivalent circuits may be aborted as well, since the intermediate result need not be close to the identity (for G_I_Gp method)
+				)pbdoc")
+            .def_readwrite("lookahead_depth", &ec::Configuration::lookaheadDepth,
+                           R"pbdoc(
+					Number of gate applications planned ahead (for beam lookahead strategy)
+				)pbdoc")
+            .def_readwrite("lookahead_beam_width", &ec::Configuration::lookaheadBeamWidth,
+                           R"pbdoc(
+					Number of branches kept while planning ahead (for beam lookahead strategy)
+				)pbdoc")
+            .def_readwrite("size_feedback_max_imbalance", &ec::Configuration::sizeFeedbackMaxImbalance,
+                           R"pbdoc(
+					Maximum factor by which the ratio of applications may deviate from the gate count ratio (for size feedback strategy)
+				)pbdoc")
             .def_readwrite("reconstruct_swaps", &ec::Configuration::reconstructSWAPs,
                            R"pbdoc(
 					Optimization pass reconstructing SWAP operations
@@ -138,6 +263,14 @@ PYBIND11_MODULE(pyqcec, m) {
                            R"pbdoc(
 					Optimization pass removing diagonal gates before measurements
 				)pbdoc")
+            .def_readwrite("cancel_miter_gates", &ec::Configuration::cancelMiterGates,
+                           R"pbdoc(
+					Optimization pass cancelling inverse gates, merging rotations, and removing identities in the miter of both circuits
+				)pbdoc")
+            .def_readwrite("strip_common_gates", &ec::Configuration::stripCommonGates,
+                           R"pbdoc(
+					Optimization pass stripping the longest common prefix and suffix (up to commuting gates) of both circuits
+				)pbdoc")
             .def_readwrite("fidelity", &ec::Configuration::fidelity_limit,
                            R"pbdoc(
 					Fidelity limit for comparison (for simulation method)
@@ -153,6 +286,10 @@ PYBIND11_MODULE(pyqcec, m) {
 					- localquantum
 					- globalquantum
 				)pbdoc")
+            .def_readwrite("global_stimuli_depth", &ec::Configuration::globalStimuliDepth,
+                           R"pbdoc(
+					Number of random Clifford layers used to sample global quantum stimuli (0 chooses log2(n) layers)
+				)pbdoc")
             .def_readwrite("store_cex_input", &ec::Configuration::storeCEXinput,
                            R"pbdoc(
 					Store counterexample input state vector (for simulation method)
@@ -161,6 +298,73 @@ PYBIND11_MODULE(pyqcec, m) {
                            R"pbdoc(
 					Store resulting counterexample state vectors (for simulation method)
 				)pbdoc")
+            .def_readwrite("simulation_backend", &ec::Configuration::simulationBackend,
+                           R"pbdoc(
+					Representation of the states during simulation (for simulation method):
+					- decision_diagram (*default*)
+					- dense
+					- adaptive
+				)pbdoc")
+            .def_readwrite("dense_switch_threshold", &ec::Configuration::denseSwitchThreshold,
+                           R"pbdoc(
+					Switch to a dense state once the active DD nodes occupy more than this fraction of the memory of a dense state (for adaptive simulation backend)
+				)pbdoc")
+            .def_readwrite("approximation_node_budget", &ec::Configuration::approximationNodeBudget,
+                           R"pbdoc(
+					Prune the simulated states whenever they exceed this many nodes, accounting for the fidelity lost (0 disables the approximation, for simulation method)
+				)pbdoc")
+            .def_readwrite("concurrent_circuit_simulation", &ec::Configuration::concurrentCircuitSimulation,
+                           R"pbdoc(
+					Simulate both circuits on separate threads and DD packages (for simulation method)
+				)pbdoc")
+            .def_readwrite("difference_guided_stimuli", &ec::Configuration::differenceGuidedStimuli,
+                           R"pbdoc(
+					Bias stimuli towards the qubits affecting structural differences between both circuits (for simulation method)
+				)pbdoc")
+            .def_readwrite("adaptive_stimuli", &ec::Configuration::adaptiveStimuli,
+                           R"pbdoc(
+					Choose the stimuli type of every simulation adaptively and stop once equivalence is suggested with the requested confidence (for simulation method)
+				)pbdoc")
+            .def_readwrite("equivalence_confidence", &ec::Configuration::equivalenceConfidence,
+                           R"pbdoc(
+					Confidence of equivalence (derived from the assumed detection probabilities) at which adaptive simulation stops
+				)pbdoc")
+            .def_readwrite("classical_detection_probability", &ec::Configuration::classicalDetectionProbability,
+                           R"pbdoc(
+					Assumed probability of a classical stimulus to expose a non-equivalence (for adaptive simulation)
+				)pbdoc")
+            .def_readwrite("local_quantum_detection_probability", &ec::Configuration::localQuantumDetectionProbability,
+                           R"pbdoc(
+					Assumed probability of a local quantum stimulus to expose a non-equivalence (for adaptive simulation)
+				)pbdoc")
+            .def_readwrite("global_quantum_detection_probability", &ec::Configuration::globalQuantumDetectionProbability,
+                           R"pbdoc(
+					Assumed probability of a global quantum stimulus to expose a non-equivalence (for adaptive simulation)
+				)pbdoc")
+            .def_readwrite("simulation_cache_directory", &ec::Configuration::simulationCacheDirectory,
+                           R"pbdoc(
+					Directory in which the outputs of the first circuit are persisted for every stimulus (empty disables the cache; for simulation method)
+				)pbdoc")
+            .def_readwrite("simulation_cache_size", &ec::Configuration::simulationCacheSize,
+                           R"pbdoc(
+					Maximum size of the simulation cache in bytes before the least recently used entries are evicted
+				)pbdoc")
+            .def_readwrite("estimate_fidelity", &ec::Configuration::estimateFidelity,
+                           R"pbdoc(
+					Estimate the average fidelity from random stimuli instead of checking equivalence (for simulation method)
+				)pbdoc")
+            .def_readwrite("fidelity_confidence", &ec::Configuration::fidelityConfidence,
+                           R"pbdoc(
+					Confidence level of the fidelity estimate's interval (for simulation method)
+				)pbdoc")
+            .def_readwrite("fidelity_ci_width", &ec::Configuration::fidelityCIWidth,
+                           R"pbdoc(
+					Stop sampling once the confidence interval is narrower than this (for simulation method)
+				)pbdoc")
+            .def_readwrite("fidelity_min_sims", &ec::Configuration::fidelityMinSims,
+                           R"pbdoc(
+					Minimum number of samples before the stopping rule applies (for simulation method)
+				)pbdoc")
             .def("__repr__", &ec::Configuration::toString);
 
     py::class_<ec::EquivalenceCheckingResults>(m, "Results",
@@ -231,6 +435,201 @@ PYBIND11_MODULE(pyqcec, m) {
                     R"pbdoc(
 					Fidelity of the two resulting states
 				)pbdoc")
+            .def_readwrite(
+                    "fidelity_lower_bound", &ec::EquivalenceCheckingResults::fidelityLowerBound,
+                    R"pbdoc(
+					Guaranteed lower bound on the fidelity of the exact resulting states (for approximate simulation)
+				)pbdoc")
+            .def_readwrite(
+                    "fidelity_upper_bound", &ec::EquivalenceCheckingResults::fidelityUpperBound,
+                    R"pbdoc(
+					Guaranteed upper bound on the fidelity of the exact resulting states (for approximate simulation)
+				)pbdoc")
+            .def_readwrite(
+                    "approximations", &ec::EquivalenceCheckingResults::approximations,
+                    R"pbdoc(
+					Number of times a simulated state has been approximated
+				)pbdoc")
+            .def_readwrite(
+                    "approximation_peak_nodes", &ec::EquivalenceCheckingResults::approximationPeakNodes,
+                    R"pbdoc(
+					Maximum number of nodes of the (approximated) simulated states
+				)pbdoc")
+            .def_readwrite(
+                    "dense_switches", &ec::EquivalenceCheckingResults::denseSwitches,
+                    R"pbdoc(
+					Number of simulations that switched from decision diagrams to dense states (for adaptive simulation backend)
+				)pbdoc")
+            .def_readwrite(
+                    "dense_switch_gate", &ec::EquivalenceCheckingResults::denseSwitchGate,
+                    R"pbdoc(
+					Index of the gate after which the first switch to a dense state happened
+				)pbdoc")
+            .def_readwrite(
+                    "dense_conversion_time", &ec::EquivalenceCheckingResults::denseConversionTime,
+                    R"pbdoc(
+					Time spent converting decision diagrams to dense states
+				)pbdoc")
+            .def_readwrite(
+                    "peak_state_memory", &ec::EquivalenceCheckingResults::peakStateMemory,
+                    R"pbdoc(
+					Peak memory (in bytes) occupied by a simulated state (for adaptive simulation backend)
+				)pbdoc")
+            .def_readwrite(
+                    "trace_computed", &ec::EquivalenceCheckingResults::traceComputed,
+                    R"pbdoc(
+					Whether the trace of the resulting functionality has been computed
+				)pbdoc")
+            .def_readwrite(
+                    "trace", &ec::EquivalenceCheckingResults::trace,
+                    R"pbdoc(
+					Trace of the resulting functionality (G -> I <- G' scheme)
+				)pbdoc")
+            .def_readwrite(
+                    "process_fidelity", &ec::EquivalenceCheckingResults::processFidelity,
+                    R"pbdoc(
+					Process fidelity |tr(U)|^2 / 4^n of the resulting functionality (G -> I <- G' scheme)
+				)pbdoc")
+            .def_readwrite(
+                    "fidelity_estimate", &ec::EquivalenceCheckingResults::fidelityEstimate,
+                    R"pbdoc(
+					Estimated average fidelity (for simulation method)
+				)pbdoc")
+            .def_readwrite(
+                    "ci_low", &ec::EquivalenceCheckingResults::ciLow,
+                    R"pbdoc(
+					Lower end of the confidence interval of the fidelity estimate
+				)pbdoc")
+            .def_readwrite(
+                    "ci_high", &ec::EquivalenceCheckingResults::ciHigh,
+                    R"pbdoc(
+					Upper end of the confidence interval of the fidelity estimate
+				)pbdoc")
+            .def_readwrite(
+                    "miter_removed_gates1", &ec::EquivalenceCheckingResults::miterRemovedGates1,
+                    R"pbdoc(
+					Number of gates removed from the first circuit by the miter cancellation pass
+				)pbdoc")
+            .def_readwrite(
+                    "miter_removed_gates2", &ec::EquivalenceCheckingResults::miterRemovedGates2,
+                    R"pbdoc(
+					Number of gates removed from the second circuit by the miter cancellation pass
+				)pbdoc")
+            .def_readwrite(
+                    "miter_merged_rotations", &ec::EquivalenceCheckingResults::miterMergedRotations,
+                    R"pbdoc(
+					Number of rotations merged by the miter cancellation pass
+				)pbdoc")
+            .def_readwrite(
+                    "stripped_prefix", &ec::EquivalenceCheckingResults::strippedPrefix,
+                    R"pbdoc(
+					Number of gates stripped from the beginning of each circuit by the common gate stripping pass
+				)pbdoc")
+            .def_readwrite(
+                    "stripped_suffix", &ec::EquivalenceCheckingResults::strippedSuffix,
+                    R"pbdoc(
+					Number of gates stripped from the end of each circuit by the common gate stripping pass
+				)pbdoc")
+            .def_readwrite(
+                    "remaining_gates1", &ec::EquivalenceCheckingResults::remainingGates1,
+                    R"pbdoc(
+					Number of gates of the first circuit left after the common gate stripping pass
+				)pbdoc")
+            .def_readwrite(
+                    "remaining_gates2", &ec::EquivalenceCheckingResults::remainingGates2,
+                    R"pbdoc(
+					Number of gates of the second circuit left after the common gate stripping pass
+				)pbdoc")
+            .def_readwrite(
+                    "heuristically_aborted", &ec::EquivalenceCheckingResults::heuristicallyAborted,
+                    R"pbdoc(
+					Whether the check has been aborted heuristically because of a low sampled process fidelity
+				)pbdoc")
+            .def_readwrite(
+                    "abort_gate_index", &ec::EquivalenceCheckingResults::abortGateIndex,
+                    R"pbdoc(
+					Total number of gates consumed when the check was aborted
+				)pbdoc")
+            .def_readwrite(
+                    "abort_fidelity", &ec::EquivalenceCheckingResults::abortFidelity,
+                    R"pbdoc(
+					Sampled process fidelity that triggered the abort
+				)pbdoc")
+            .def_readwrite(
+                    "limit_exceeded", &ec::EquivalenceCheckingResults::limitExceeded,
+                    R"pbdoc(
+					Whether the check was given up because a resource limit was exceeded
+				)pbdoc")
+            .def_readwrite(
+                    "limit_reason", &ec::EquivalenceCheckingResults::limitReason,
+                    R"pbdoc(
+					Resource limit that was exceeded (active nodes or resident memory)
+				)pbdoc")
+            .def_readwrite(
+                    "limit_gates1", &ec::EquivalenceCheckingResults::limitGates1,
+                    R"pbdoc(
+					Number of gates of the first circuit consumed when the resource limit was exceeded
+				)pbdoc")
+            .def_readwrite(
+                    "limit_gates2", &ec::EquivalenceCheckingResults::limitGates2,
+                    R"pbdoc(
+					Number of gates of the second circuit consumed when the resource limit was exceeded
+				)pbdoc")
+            .def_readwrite(
+                    "peak_resident_memory", &ec::EquivalenceCheckingResults::peakResidentMemory,
+                    R"pbdoc(
+					Peak resident memory in bytes sampled while checking the resource limits
+				)pbdoc")
+            .def_readwrite(
+                    "gc_collections", &ec::EquivalenceCheckingResults::gcCollections,
+                    R"pbdoc(
+					Number of garbage collections triggered after applying gates
+				)pbdoc")
+            .def_readwrite(
+                    "gc_time", &ec::EquivalenceCheckingResults::gcTime,
+                    R"pbdoc(
+					Time spent on garbage collections
+				)pbdoc")
+            .def_readwrite(
+                    "gc_reclaimed_nodes", &ec::EquivalenceCheckingResults::gcReclaimedNodes,
+                    R"pbdoc(
+					Number of unique table nodes reclaimed by garbage collections
+				)pbdoc")
+            .def_readwrite(
+                    "gc_peak_nodes", &ec::EquivalenceCheckingResults::gcPeakNodes,
+                    R"pbdoc(
+					Peak number of nodes held by the unique tables (alive or not)
+				)pbdoc")
+            .def_readwrite(
+                    "gate_cache_hits", &ec::EquivalenceCheckingResults::gateCacheHits,
+                    R"pbdoc(
+					Number of gate DDs taken from the gate cache
+				)pbdoc")
+            .def_readwrite(
+                    "gate_cache_misses", &ec::EquivalenceCheckingResults::gateCacheMisses,
+                    R"pbdoc(
+					Number of gate DDs that had to be constructed
+				)pbdoc")
+            .def_readwrite(
+                    "equivalence_confidence", &ec::EquivalenceCheckingResults::equivalenceConfidence,
+                    R"pbdoc(
+					Confidence of equivalence (for adaptive simulation) derived from the assumed detection probabilities of the stimuli types, i.e., not a measured confidence
+				)pbdoc")
+            .def_readwrite(
+                    "simulation_cache_hits", &ec::EquivalenceCheckingResults::simulationCacheHits,
+                    R"pbdoc(
+					Number of outputs of the first circuit loaded from the simulation cache
+				)pbdoc")
+            .def_readwrite(
+                    "simulation_cache_misses", &ec::EquivalenceCheckingResults::simulationCacheMisses,
+                    R"pbdoc(
+					Number of outputs of the first circuit that had to be simulated (and were added to the simulation cache)
+				)pbdoc")
+            .def_readwrite(
+                    "guided_qubits", &ec::EquivalenceCheckingResults::guidedQubits,
+                    R"pbdoc(
+					Number of qubits excited by difference-guided stimuli
+				)pbdoc")
             .def("__repr__", &ec::EquivalenceCheckingResults::toString)
             .def_static("csv_header", &ec::EquivalenceCheckingResults::getCSVHeader)
             .def("csv", &ec::EquivalenceCheckingResults::produceCSVEntry)
@@ -264,6 +663,9 @@ PYBIND11_MODULE(pyqcec, m) {
     m.def("verify", &verify, "verify the equivalence of two circuits",
           "circ1"_a, "circ2"_a,
           "config"_a = ec::Configuration{});
+    m.def("verify_candidates", &verify_candidates, "verify the equivalence of a reference circuit and each of the candidate circuits (using the simulation method)",
+          "reference"_a, "candidates"_a,
+          "config"_a = ec::Configuration{});
 
 #ifdef VERSION_INFO
     m.attr("__version__") = VERSION_INFO;
@@ -0,0 +1,202 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "Approximation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ec {
+    using vNode = dd::Package::vNode;
+
+    namespace {
+        std::complex<dd::fp> value(const dd::Complex& c) {
+            return {dd::CTEntry::val(c.r), dd::CTEntry::val(c.i)};
+        }
+
+        dd::fp mag2(const dd::Complex& c) {
+            return std::norm(value(c));
+        }
+
+        struct Contribution {
+            const vNode* p     = nullptr;
+            std::size_t  index = 0U;
+            dd::fp       mass  = 0.;
+        };
+    } // namespace
+
+    qc::VectorDD approximate(const qc::VectorDD& e, std::size_t maxNodes, std::unique_ptr<dd::Package>& package, dd::fp& fidelity) {
+        fidelity = 1.;
+        if (e.w.approximatelyZero() || vNode::isTerminal(e.p)) {
+            return e;
+        }
+
+        // nodes in post-order, i.e., every node succeeds its children
+        std::vector<const vNode*>                 nodes{};
+        std::unordered_map<const vNode*, dd::fp>  norm{}; // squared norm of the sub-vector represented by the node
+        const std::function<dd::fp(const vNode*)> collect = [&](const vNode* p) -> dd::fp {
+            if (vNode::isTerminal(p)) {
+                return 1.;
+            }
+            if (const auto it = norm.find(p); it != norm.end()) {
+                return it->second;
+            }
+            dd::fp n = 0.;
+            for (const auto& child: p->e) {
+                if (!child.w.approximatelyZero()) {
+                    n += mag2(child.w) * collect(child.p);
+                }
+            }
+            norm.emplace(p, n);
+            nodes.emplace_back(p);
+            return n;
+        };
+        const auto total = mag2(e.w) * collect(e.p);
+
+        // the probability mass reaching every node is propagated from the root towards the terminal
+        std::unordered_map<const vNode*, dd::fp> reach{};
+        reach[e.p] = mag2(e.w);
+        std::vector<Contribution> contributions{};
+        contributions.reserve(2U * nodes.size());
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            const auto* p    = *it;
+            const auto  mass = reach[p];
+            for (std::size_t i = 0U; i < p->e.size(); ++i) {
+                const auto& child = p->e[i];
+                if (child.w.approximatelyZero()) {
+                    continue;
+                }
+                const auto through = mass * mag2(child.w);
+                if (!vNode::isTerminal(child.p)) {
+                    reach[child.p] += through;
+                }
+                contributions.push_back({p, i, through * (vNode::isTerminal(child.p) ? 1. : norm[child.p]) / total});
+            }
+        }
+        std::sort(contributions.begin(), contributions.end(), [](const auto& a, const auto& b) { return a.mass < b.mass; });
+
+        // rebuild e without the removed edges. The result is normalized, and kept is the probability mass that remains.
+        // Returns false if no mass remains.
+        std::unordered_set<const vNode*> removed0{};
+        std::unordered_set<const vNode*> removed1{};
+        const auto                       prune = [&](qc::VectorDD& pruned, dd::fp& kept) {
+            std::unordered_map<const vNode*, qc::VectorDD>  visited{};
+            const std::function<qc::VectorDD(const vNode*)> rebuild = [&](const vNode* p) -> qc::VectorDD {
+                if (vNode::isTerminal(p)) {
+                    return qc::VectorDD::terminal(dd::Complex::one);
+                }
+                if (const auto it = visited.find(p); it != visited.end()) {
+                    return it->second;
+                }
+                std::array<qc::VectorDD, 2> edges{};
+                for (std::size_t i = 0U; i < edges.size(); ++i) {
+                    const auto& child = p->e[i];
+                    if (child.w.approximatelyZero() || (i == 0U ? removed0 : removed1).count(p) > 0U) {
+                        edges[i] = qc::VectorDD::zero;
+                        continue;
+                    }
+                    const auto sub = rebuild(child.p);
+                    if (sub.w.approximatelyZero()) {
+                        edges[i] = qc::VectorDD::zero;
+                        continue;
+                    }
+                    const auto w = value(child.w) * value(sub.w);
+                    edges[i]     = qc::VectorDD{sub.p, package->cn.lookup(w.real(), w.imag())};
+                }
+                auto node = package->makeDDNode(p->v, edges);
+                visited.emplace(p, node);
+                return node;
+            };
+            pruned = rebuild(e.p);
+            if (pruned.w.approximatelyZero()) {
+                return false;
+            }
+            const auto w = value(e.w) * value(pruned.w);
+            pruned.w     = package->cn.lookup(w.real(), w.imag());
+
+            // the pruned state is the projection of e onto the remaining basis states, whose squared norm is the fidelity
+            kept         = package->innerProduct(pruned, pruned).r / total;
+            const auto n = value(pruned.w) / std::sqrt(kept * total);
+            pruned.w     = package->cn.lookup(n.real(), n.imag());
+            return true;
+        };
+        // try to remove the k least contributing edges
+        const auto fits = [&](std::size_t k, qc::VectorDD& pruned, dd::fp& kept) {
+            removed0.clear();
+            removed1.clear();
+            for (std::size_t i = 0U; i < k; ++i) {
+                (contributions[i].index == 0U ? removed0 : removed1).insert(contributions[i].p);
+            }
+            return prune(pruned, kept) && package->size(pruned) <= maxNodes;
+        };
+
+        // double k until the DD is small enough and, if the last step removed too much, search for the smallest sufficient k
+        // in between (the size of the DD shrinks with k almost monotonically)
+        qc::VectorDD pruned{};
+        dd::fp       kept  = 1.;
+        std::size_t  small = 0U; // largest k known to be insufficient
+        for (std::size_t k = 1U; k <= contributions.size(); k *= 2U) {
+            if (fits(k, pruned, kept)) {
+                fidelity = std::min(1., kept);
+                return pruned;
+            }
+            small = k;
+        }
+        auto large = contributions.size() + 1U;
+        while (large - small > 1U) {
+            const auto mid = small + (large - small) / 2U;
+            if (fits(mid, pruned, kept)) {
+                large = mid;
+            } else {
+                small = mid;
+            }
+        }
+        if (large <= contributions.size() && fits(large, pruned, kept)) {
+            fidelity = std::min(1., kept);
+            return pruned;
+        }
+
+        // as a last resort, keep only the most probable basis state, which takes one node per qubit
+        removed0.clear();
+        removed1.clear();
+        for (const auto* p = e.p; !vNode::isTerminal(p);) {
+            std::array<dd::fp, 2> mass{};
+            for (std::size_t i = 0U; i < mass.size(); ++i) {
+                const auto& child = p->e[i];
+                if (!child.w.approximatelyZero()) {
+                    mass[i] = mag2(child.w) * (vNode::isTerminal(child.p) ? 1. : norm[child.p]);
+                }
+            }
+            const auto i = (mass[1] > mass[0]) ? 1U : 0U;
+            (i == 0U ? removed1 : removed0).insert(p);
+            p = p->e[i].p;
+        }
+        prune(pruned, kept);
+        fidelity = std::min(1., kept);
+        return pruned;
+    }
+
+    dd::fp fidelityLowerBound(dd::fp approximatedFidelity, dd::fp angle) {
+        const auto theta = std::acos(std::sqrt(std::clamp(approximatedFidelity, 0., 1.))) + angle;
+        if (theta >= dd::PI_2) {
+            return 0.;
+        }
+        return std::pow(std::cos(theta), 2);
+    }
+
+    dd::fp fidelityUpperBound(dd::fp approximatedFidelity, dd::fp angle) {
+        const auto theta = std::acos(std::sqrt(std::clamp(approximatedFidelity, 0., 1.))) - angle;
+        if (theta <= 0.) {
+            return 1.;
+        }
+        return std::pow(std::cos(theta), 2);
+    }
+} // namespace ec
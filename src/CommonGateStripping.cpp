@@ -0,0 +1,173 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "CommonGateStripping.hpp"
+
+#include "CommutationDAG.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace ec {
+    namespace {
+        /// Gate acting on logical qubits
+        struct LogicalGate {
+            qc::OpType                                           type = qc::None;
+            std::array<dd::fp, 3>                                parameter{};
+            std::vector<dd::Qubit>                               targets{};
+            std::vector<std::pair<dd::Qubit, dd::Control::Type>> controls{};
+
+            [[nodiscard]] bool equals(const LogicalGate& other, const dd::fp tolerance) const {
+                return type == other.type && targets == other.targets && controls == other.controls &&
+                       std::equal(parameter.begin(), parameter.end(), other.parameter.begin(), [&](const auto a, const auto b) {
+                           return std::abs(a - b) <= tolerance;
+                       });
+            }
+        };
+
+        bool isAbsorbable(const qc::Operation& op) {
+            return op.isStandardOperation() && op.getType() == qc::SWAP && !op.isControlled();
+        }
+
+        void swapEntries(qc::Permutation& perm, dd::Qubit a, dd::Qubit b) {
+            const auto ia = perm.find(a);
+            const auto ib = perm.find(b);
+            if (ia != perm.end() && ib != perm.end()) {
+                std::swap(ia->second, ib->second);
+            } else if (ia != perm.end()) {
+                perm[b] = ia->second;
+                perm.erase(ia);
+            } else if (ib != perm.end()) {
+                perm[a] = ib->second;
+                perm.erase(ib);
+            }
+        }
+
+        /// The operation resolved to the logical qubits it acts on or nothing if it must not be stripped
+        std::optional<LogicalGate> resolve(const qc::Operation& op, const qc::Permutation& layout, const std::vector<bool>& excluded) {
+            if (!op.isStandardOperation() || !op.isUnitary()) {
+                return std::nullopt;
+            }
+
+            bool       strippable = true;
+            const auto toLogical  = [&](dd::Qubit qubit) {
+                const auto it = layout.find(qubit);
+                if (it == layout.end()) {
+                    strippable = false;
+                    return qubit;
+                }
+                const auto logical = static_cast<std::size_t>(it->second);
+                if (logical < excluded.size() && excluded[logical]) {
+                    strippable = false;
+                }
+                return it->second;
+            };
+
+            LogicalGate gate{};
+            gate.type      = op.getType();
+            gate.parameter = op.getParameter();
+            for (const auto target: op.getTargets()) {
+                gate.targets.emplace_back(toLogical(target));
+            }
+            if (gate.type == qc::SWAP) {
+                std::sort(gate.targets.begin(), gate.targets.end());
+            }
+            for (const auto& control: op.getControls()) {
+                gate.controls.emplace_back(toLogical(control.qubit), control.type);
+            }
+            std::sort(gate.controls.begin(), gate.controls.end());
+
+            if (!strippable) {
+                return std::nullopt;
+            }
+            return gate;
+        }
+
+        /// Uncontrolled SWAPs in the frontier only alter the layout of the qubits they act on
+        void absorbSWAPs(const qc::QuantumComputation& qc, CommutationDAG& dag, qc::Permutation& layout, std::vector<std::size_t>& erase) {
+            for (auto absorbed = true; absorbed;) {
+                absorbed = false;
+                for (const auto index: dag.frontier()) {
+                    const auto& op = *std::next(qc.begin(), static_cast<std::ptrdiff_t>(index));
+                    if (isAbsorbable(*op)) {
+                        swapEntries(layout, op->getTargets().at(0), op->getTargets().at(1));
+                        dag.markApplied(index);
+                        erase.emplace_back(index);
+                        absorbed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        void eraseOperations(qc::QuantumComputation& qc, std::vector<std::size_t>& erase) {
+            std::sort(erase.begin(), erase.end(), std::greater<>());
+            for (const auto index: erase) {
+                qc.erase(std::next(qc.cbegin(), static_cast<std::ptrdiff_t>(index)));
+            }
+        }
+
+        /// Strip pairs of identical gates from the frontiers of both circuits (consumed from their end if reversed) until
+        /// the frontiers do not share any gate. Returns the number of stripped pairs.
+        std::size_t strip(qc::QuantumComputation& qc1, qc::Permutation& layout1, qc::QuantumComputation& qc2, qc::Permutation& layout2,
+                          const std::vector<bool>& excluded, bool reversed, const dd::fp tolerance) {
+            CommutationDAG           dag1(qc1, reversed);
+            CommutationDAG           dag2(qc2, reversed);
+            std::vector<std::size_t> erase1{};
+            std::vector<std::size_t> erase2{};
+            std::size_t              stripped = 0U;
+
+            while (true) {
+                absorbSWAPs(qc1, dag1, layout1, erase1);
+                absorbSWAPs(qc2, dag2, layout2, erase2);
+
+                std::optional<std::pair<std::size_t, std::size_t>> match{};
+                for (const auto i: dag1.frontier()) {
+                    const auto gate1 = resolve(**std::next(qc1.begin(), static_cast<std::ptrdiff_t>(i)), layout1, excluded);
+                    if (!gate1) {
+                        continue;
+                    }
+                    for (const auto j: dag2.frontier()) {
+                        const auto gate2 = resolve(**std::next(qc2.begin(), static_cast<std::ptrdiff_t>(j)), layout2, excluded);
+                        if (gate2 && gate1->equals(*gate2, tolerance)) {
+                            match = {i, j};
+                            break;
+                        }
+                    }
+                    if (match) {
+                        break;
+                    }
+                }
+                if (!match) {
+                    break;
+                }
+
+                dag1.markApplied(match->first);
+                dag2.markApplied(match->second);
+                erase1.emplace_back(match->first);
+                erase2.emplace_back(match->second);
+                ++stripped;
+            }
+
+            eraseOperations(qc1, erase1);
+            eraseOperations(qc2, erase2);
+            return stripped;
+        }
+    } // namespace
+
+    CommonGateStrippingStatistics stripCommonGates(qc::QuantumComputation& qc1, qc::Permutation& initial1, qc::Permutation& output1,
+                                                   qc::QuantumComputation& qc2, qc::Permutation& initial2, qc::Permutation& output2,
+                                                   const std::vector<bool>& ancillary, const std::vector<bool>& garbage, const dd::fp tolerance) {
+        CommonGateStrippingStatistics stats{};
+        // gates at the beginning act on the logical qubits given by the initial layout (where the state of ancillaries is fixed)
+        stats.strippedPrefix = strip(qc1, initial1, qc2, initial2, ancillary, false, tolerance);
+        // gates at the end act on the logical qubits given by the output permutation (where garbage outputs are ignored)
+        stats.strippedSuffix  = strip(qc1, output1, qc2, output2, garbage, true, tolerance);
+        stats.remainingGates1 = qc1.getNops();
+        stats.remainingGates2 = qc2.getNops();
+        return stats;
+    }
+} // namespace ec
@@ -0,0 +1,121 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "CommutationDAG.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace ec {
+    std::vector<std::pair<dd::Qubit, CommutationDAG::Role>> CommutationDAG::roles(const qc::Operation& op, dd::QubitCount nqubits) {
+        std::vector<std::pair<dd::Qubit, Role>> result{};
+        if (!op.isStandardOperation()) {
+            for (dd::QubitCount q = 0U; q < nqubits; ++q) {
+                if (op.actsOn(static_cast<dd::Qubit>(q))) {
+                    result.emplace_back(static_cast<dd::Qubit>(q), Role::General);
+                }
+            }
+            return result;
+        }
+
+        for (const auto& control: op.getControls()) {
+            result.emplace_back(control.qubit, Role::Z);
+        }
+        const auto& targets = op.getTargets();
+        if (targets.size() != 1U) {
+            for (const auto& target: targets) {
+                result.emplace_back(target, Role::General);
+            }
+            return result;
+        }
+
+        switch (op.getType()) {
+            case qc::I:
+            case qc::Z:
+            case qc::S:
+            case qc::Sdag:
+            case qc::T:
+            case qc::Tdag:
+            case qc::Phase:
+            case qc::RZ:
+                result.emplace_back(targets.front(), Role::Z);
+                break;
+            case qc::X:
+            case qc::RX:
+            case qc::SX:
+            case qc::SXdag:
+            case qc::V:
+            case qc::Vdag:
+                result.emplace_back(targets.front(), Role::X);
+                break;
+            default:
+                result.emplace_back(targets.front(), Role::General);
+                break;
+        }
+        return result;
+    }
+
+    CommutationDAG::CommutationDAG(const qc::QuantumComputation& qc, bool reversed) {
+        const auto nops    = qc.getNops();
+        const auto nqubits = static_cast<dd::QubitCount>(qc.getNqubits());
+        successors.resize(nops);
+        predecessors.resize(nops, 0U);
+
+        // Per qubit, the operations of the latest group (which mutually commute on the qubit) and of the group before it.
+        // A new operation either joins the latest group and depends on the group before, or starts a new group and depends
+        // on all operations of the latest group.
+        struct Group {
+            Role                     role = Role::General;
+            std::vector<std::size_t> ops{};
+        };
+        std::vector<Group>                    current(nqubits);
+        std::vector<std::vector<std::size_t>> previous(nqubits);
+
+        std::vector<std::size_t> preds{};
+        for (std::size_t i = 0U; i < nops; ++i) {
+            const auto  index = reversed ? nops - 1U - i : i;
+            const auto& op    = *std::next(qc.begin(), static_cast<std::ptrdiff_t>(index));
+            preds.clear();
+            for (const auto& [qubit, role]: roles(*op, nqubits)) {
+                const auto q     = static_cast<std::size_t>(qubit);
+                auto&      group = current.at(q);
+                if (group.ops.empty() || role == Role::General || group.role != role) {
+                    previous[q] = std::move(group.ops);
+                    group.ops   = {};
+                    group.role  = role;
+                }
+                group.ops.emplace_back(index);
+                preds.insert(preds.end(), previous[q].begin(), previous[q].end());
+            }
+
+            std::sort(preds.begin(), preds.end());
+            preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+            for (const auto pred: preds) {
+                successors[pred].emplace_back(index);
+            }
+            predecessors[index] = preds.size();
+            if (preds.empty()) {
+                front.emplace_back(index);
+            }
+        }
+        std::sort(front.begin(), front.end());
+    }
+
+    void CommutationDAG::markApplied(std::size_t op) {
+        const auto it = std::lower_bound(front.begin(), front.end(), op);
+        if (it == front.end() || *it != op) {
+            throw std::invalid_argument("Operation " + std::to_string(op) + " is not part of the frontier.");
+        }
+        front.erase(it);
+        ++applied;
+
+        for (const auto succ: successors[op]) {
+            if (--predecessors[succ] == 0U) {
+                front.insert(std::lower_bound(front.begin(), front.end(), succ), succ);
+            }
+        }
+    }
+} // namespace ec
@@ -8,6 +8,7 @@
 namespace ec {
 
     EquivalenceCheckingResults CompilationFlowEquivalenceChecker::check(const ec::Configuration& config) {
+        ToleranceGuard             guard(config.tolerance);
         EquivalenceCheckingResults results{};
         setupResults(results);
         results.strategy = Strategy::CompilationFlow;
@@ -20,7 +21,7 @@ namespace ec {
         auto perm2     = initial2;
         results.result = createInitialMatrix();
 
-        while (it1 != end1 && it2 != end2) {
+        while (it1 != end1 && it2 != end2 && !resourceLimits.hit) {
             // apply possible swaps
             while (it1 != end1 && (*it1)->getType() == qc::SWAP) {
                 applyGate(*it1, results.result, perm1, LEFT);
@@ -36,7 +37,7 @@ namespace ec {
                 auto cost1 = costFunction((*it1)->getType(), (*it1)->getControls().size());
                 auto cost2 = costFunction((*it2)->getType(), (*it2)->getControls().size());
 
-                for (unsigned long long i = 0; i < cost2 && it1 != end1; ++i) {
+                for (unsigned long long i = 0; i < cost2 && it1 != end1 && !resourceLimits.hit; ++i) {
                     applyGate(qc1, it1, results.result, perm1, LEFT);
                     ++it1;
 
@@ -47,7 +48,7 @@ namespace ec {
                     }
                 }
 
-                for (unsigned long long i = 0; i < cost1 && it2 != end2; ++i) {
+                for (unsigned long long i = 0; i < cost1 && it2 != end2 && !resourceLimits.hit; ++i) {
                     applyGate(qc2, it2, results.result, perm2, RIGHT);
                     ++it2;
 
@@ -60,17 +61,31 @@ namespace ec {
             }
         }
         // finish first circuit
-        while (it1 != end1) {
+        while (it1 != end1 && !resourceLimits.hit) {
             applyGate(qc1, it1, results.result, perm1, LEFT);
             ++it1;
         }
 
         // finish second circuit
-        while (it2 != end2) {
+        while (it2 != end2 && !resourceLimits.hit) {
             applyGate(qc2, it2, results.result, perm2, RIGHT);
             ++it2;
         }
 
+        if (resourceLimits.hit) {
+            limitGates1       = static_cast<std::size_t>(std::distance(qc1.begin(), it1));
+            limitGates2       = static_cast<std::size_t>(std::distance(qc2.begin(), it2));
+            results.maxActive = std::max(results.maxActive, dd->mUniqueTable.getMaxActiveNodes());
+            storeStatistics(results);
+
+            auto                          endVerification   = std::chrono::steady_clock::now();
+            std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+            std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+            results.preprocessingTime                       = preprocessingTime.count();
+            results.verificationTime                        = verificationTime.count();
+            return results;
+        }
+
         qc::QuantumComputation::changePermutation(results.result, perm1, output1, dd, LEFT);
         qc::QuantumComputation::changePermutation(results.result, perm2, output2, dd, RIGHT);
         results.result = dd->reduceGarbage(results.result, garbage1, LEFT);
@@ -87,6 +102,7 @@ namespace ec {
         results.preprocessingTime                       = preprocessingTime.count();
         results.verificationTime                        = verificationTime.count();
         results.maxActive                               = std::max(results.maxActive, dd->mUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
 
         return results;
     }
@@ -0,0 +1,99 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "CrossPackage.hpp"
+
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace ec {
+    using vNode = dd::Package::vNode;
+
+    namespace {
+        std::complex<dd::fp> value(const dd::Complex& c) {
+            return {dd::CTEntry::val(c.r), dd::CTEntry::val(c.i)};
+        }
+
+        struct NodePairHash {
+            std::size_t operator()(const std::pair<const vNode*, const vNode*>& key) const {
+                const auto h1 = std::hash<const vNode*>{}(key.first);
+                const auto h2 = std::hash<const vNode*>{}(key.second);
+                return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6U) + (h1 >> 2U));
+            }
+        };
+    } // namespace
+
+    qc::VectorDD transfer(const qc::VectorDD& e, std::unique_ptr<dd::Package>& to) {
+        if (e.w.approximatelyZero()) {
+            return qc::VectorDD::zero;
+        }
+
+        // maps every node of e to the edge (with unit incoming weight) representing it in the target package
+        std::unordered_map<const vNode*, qc::VectorDD> visited{};
+
+        const std::function<qc::VectorDD(const vNode*)> rebuild = [&](const vNode* p) -> qc::VectorDD {
+            if (vNode::isTerminal(p)) {
+                return qc::VectorDD::terminal(dd::Complex::one);
+            }
+            if (auto it = visited.find(p); it != visited.end()) {
+                return it->second;
+            }
+
+            std::array<qc::VectorDD, 2> edges{};
+            for (std::size_t i = 0U; i < edges.size(); ++i) {
+                const auto& child = p->e[i];
+                if (child.w.approximatelyZero()) {
+                    edges[i] = qc::VectorDD::zero;
+                    continue;
+                }
+                const auto sub = rebuild(child.p);
+                const auto w   = value(child.w) * value(sub.w);
+                edges[i]       = qc::VectorDD{sub.p, to->cn.lookup(w.real(), w.imag())};
+            }
+            auto result = to->makeDDNode(p->v, edges);
+            visited.emplace(p, result);
+            return result;
+        };
+
+        auto       result = rebuild(e.p);
+        const auto w      = value(e.w) * value(result.w);
+        result.w          = to->cn.lookup(w.real(), w.imag());
+        return result;
+    }
+
+    std::complex<dd::fp> innerProduct(const qc::VectorDD& x, const qc::VectorDD& y) {
+        std::unordered_map<std::pair<const vNode*, const vNode*>, std::complex<dd::fp>, NodePairHash> visited{};
+
+        const std::function<std::complex<dd::fp>(const qc::VectorDD&, const qc::VectorDD&)> recurse = [&](const qc::VectorDD& a, const qc::VectorDD& b) -> std::complex<dd::fp> {
+            if (a.w.approximatelyZero() || b.w.approximatelyZero()) {
+                return {};
+            }
+            const auto weight = std::conj(value(a.w)) * value(b.w);
+            if (vNode::isTerminal(a.p) && vNode::isTerminal(b.p)) {
+                return weight;
+            }
+            if (vNode::isTerminal(a.p) || vNode::isTerminal(b.p) || a.p->v != b.p->v) {
+                throw std::invalid_argument("Inner product requires vector DDs on the same number of qubits.");
+            }
+
+            const auto key = std::pair<const vNode*, const vNode*>{a.p, b.p};
+            if (auto it = visited.find(key); it != visited.end()) {
+                return weight * it->second;
+            }
+            const auto sum = recurse(a.p->e[0], b.p->e[0]) + recurse(a.p->e[1], b.p->e[1]);
+            visited.emplace(key, sum);
+            return weight * sum;
+        };
+
+        return recurse(x, y);
+    }
+
+    dd::fp fidelity(const qc::VectorDD& x, const qc::VectorDD& y) {
+        return std::norm(innerProduct(x, y));
+    }
+} // namespace ec
@@ -0,0 +1,460 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "DenseState.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace ec {
+    using vNode = dd::Package::vNode;
+
+    namespace {
+        /// sweeps over fewer amplitudes are not worth spawning threads for
+        constexpr std::uint64_t PARALLEL_THRESHOLD = std::uint64_t{1} << 16U;
+
+        std::complex<dd::fp> value(const dd::Complex& c) {
+            return {dd::CTEntry::val(c.r), dd::CTEntry::val(c.i)};
+        }
+
+        /// Insert a zero bit at each of the (ascending) positions
+        std::uint64_t insertZeros(std::uint64_t x, const std::vector<std::size_t>& positions) {
+            for (const auto q: positions) {
+                const auto low = x & ((std::uint64_t{1} << q) - 1U);
+                x              = ((x >> q) << (q + 1U)) | low;
+            }
+            return x;
+        }
+
+        /// Threads shared by the sweeps of all dense states, so that no thread is created per gate
+        class WorkerPool {
+        public:
+            WorkerPool() {
+                // the calling thread works on a chunk of every sweep as well
+                const auto nworkers = std::max(1U, std::thread::hardware_concurrency()) - 1U;
+                for (std::size_t w = 0U; w < nworkers; ++w) {
+                    workers.emplace_back([this]() { work(); });
+                }
+            }
+            ~WorkerPool() {
+                {
+                    std::lock_guard lock(mutex);
+                    stopping = true;
+                }
+                available.notify_all();
+                for (auto& worker: workers) {
+                    worker.join();
+                }
+            }
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            /// Call f(c) for all c in [0, n) and return once all calls have finished
+            template<class F>
+            void run(std::uint64_t n, const F& f) {
+                std::mutex              doneMutex;
+                std::condition_variable done;
+                auto                    remaining = n - 1U;
+                {
+                    std::lock_guard lock(mutex);
+                    for (std::uint64_t c = 1U; c < n; ++c) {
+                        tasks.emplace_back([&, c]() {
+                            f(c);
+                            std::lock_guard doneLock(doneMutex);
+                            if (--remaining == 0U) {
+                                done.notify_one();
+                            }
+                        });
+                    }
+                }
+                available.notify_all();
+                f(std::uint64_t{0});
+
+                // help out instead of waiting idly (which also guarantees progress if there are no workers)
+                for (auto task = take(); task; task = take()) {
+                    task();
+                }
+                std::unique_lock doneLock(doneMutex);
+                done.wait(doneLock, [&]() { return remaining == 0U; });
+            }
+
+        private:
+            std::function<void()> take() {
+                std::lock_guard lock(mutex);
+                if (tasks.empty()) {
+                    return {};
+                }
+                auto task = std::move(tasks.front());
+                tasks.pop_front();
+                return task;
+            }
+
+            void work() {
+                while (true) {
+                    std::function<void()> task{};
+                    {
+                        std::unique_lock lock(mutex);
+                        available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            std::mutex                        mutex;
+            std::condition_variable           available;
+            std::deque<std::function<void()>> tasks{};
+            std::vector<std::thread>          workers{};
+            bool                              stopping = false;
+        };
+
+        WorkerPool& workerPool() {
+            static WorkerPool pool{};
+            return pool;
+        }
+
+        /// Call f(begin, end) on nthreads consecutive chunks of [0, n) concurrently if the sweep covers enough amplitudes
+        template<class F>
+        void parallelFor(std::uint64_t n, std::size_t nthreads, std::uint64_t amplitudes, const F& f) {
+            const auto chunks = std::min<std::uint64_t>(nthreads, n);
+            if (chunks <= 1U || amplitudes < PARALLEL_THRESHOLD) {
+                f(std::uint64_t{0}, n);
+                return;
+            }
+            workerPool().run(chunks, [&](std::uint64_t c) { f(n * c / chunks, n * (c + 1U) / chunks); });
+        }
+
+        /// Call f(base, run) for every basis state base with zeros at the given qubits (except for the set bits), where the
+        /// run of amplitudes base, ..., base + run - 1 shares these values. The blocks are distributed over the threads.
+        template<class F>
+        void forEachBlock(std::size_t nqubits, std::size_t nthreads, std::vector<std::size_t> qubits, std::uint64_t set, const F& f) {
+            std::sort(qubits.begin(), qubits.end());
+            const auto low     = qubits.front();
+            const auto run     = std::uint64_t{1} << low;
+            const auto nblocks = std::uint64_t{1} << (nqubits - qubits.size() - low);
+            parallelFor(nblocks, nthreads, std::uint64_t{1} << nqubits, [&](std::uint64_t begin, std::uint64_t end) {
+                for (auto b = begin; b < end; ++b) {
+                    f(insertZeros(b << low, qubits) | set, run);
+                }
+            });
+        }
+    } // namespace
+
+    DenseState::DenseState(std::size_t nqubits, std::size_t nthreads):
+        nqubits(nqubits), nthreads(nthreads == 0U ? std::max(1U, std::thread::hardware_concurrency()) : nthreads) {
+        if (nqubits > MAX_QUBITS) {
+            throw std::invalid_argument("Dense states are limited to " + std::to_string(MAX_QUBITS) + " qubits.");
+        }
+        re.assign(std::size_t{1} << nqubits, 0.);
+        im.assign(std::size_t{1} << nqubits, 0.);
+        re[0] = 1.;
+    }
+
+    DenseState DenseState::fromVectorDD(const qc::VectorDD& e, std::size_t nqubits, std::size_t nthreads) {
+        DenseState state(nqubits, nthreads);
+        state.re[0] = 0.;
+
+        const std::function<void(const qc::VectorDD&, std::uint64_t, std::complex<dd::fp>)> fill = [&](const qc::VectorDD& edge, std::uint64_t index, std::complex<dd::fp> w) {
+            if (edge.w.approximatelyZero()) {
+                return;
+            }
+            w *= value(edge.w);
+            if (vNode::isTerminal(edge.p)) {
+                state.re[index] = w.real();
+                state.im[index] = w.imag();
+                return;
+            }
+            fill(edge.p->e[0], index, w);
+            fill(edge.p->e[1], index | (std::uint64_t{1} << static_cast<std::size_t>(edge.p->v)), w);
+        };
+        fill(e, 0U, 1.);
+        return state;
+    }
+
+    qc::VectorDD DenseState::toVectorDD(std::unique_ptr<dd::Package>& dd) const {
+        const std::function<qc::VectorDD(std::size_t, std::uint64_t)> build = [&](std::size_t level, std::uint64_t index) -> qc::VectorDD {
+            if (level == 0U) {
+                const auto w = dd->cn.lookup(re[index], im[index]);
+                return w.approximatelyZero() ? qc::VectorDD::zero : qc::VectorDD::terminal(w);
+            }
+            const auto q = level - 1U;
+            return dd->makeDDNode(static_cast<dd::Qubit>(q), std::array{build(q, index), build(q, index | (std::uint64_t{1} << q))});
+        };
+        return build(nqubits, 0U);
+    }
+
+    dd::CVec DenseState::getVector() const {
+        dd::CVec vector(re.size());
+        for (std::size_t i = 0U; i < re.size(); ++i) {
+            vector[i] = {re[i], im[i]};
+        }
+        return vector;
+    }
+
+    DenseState::Matrix DenseState::gateMatrix(const qc::Operation& op) {
+        const auto k = op.getNtargets();
+        if (op.getType() == qc::SWAP) {
+            return {1., 0., 0., 0., 0., 0., 1., 0., 0., 1., 0., 0., 0., 0., 0., 1.};
+        }
+        if (k == 0U || k > 2U) {
+            throw std::invalid_argument("Operation " + op.getName() + " is not supported by dense simulation.");
+        }
+
+        // the matrix is extracted from the DD of an uncontrolled copy of the operation on its targets only
+        thread_local auto              package = std::make_unique<dd::Package>(2);
+        const auto&                    p       = op.getParameter();
+        std::unique_ptr<qc::Operation> local{};
+        if (k == 1U) {
+            local = std::make_unique<qc::StandardOperation>(1, 0, op.getType(), p[0], p[1], p[2]);
+        } else {
+            local = std::make_unique<qc::StandardOperation>(2, dd::Controls{}, 0, 1, op.getType(), p[0], p[1], p[2]);
+        }
+        qc::Permutation identity{};
+        for (std::size_t q = 0U; q < k; ++q) {
+            identity[static_cast<dd::Qubit>(q)] = static_cast<dd::Qubit>(q);
+        }
+        const auto e = local->getDD(package, identity);
+
+        const auto dim = std::size_t{1} << k;
+        Matrix     matrix(dim * dim);
+        for (std::size_t row = 0U; row < dim; ++row) {
+            for (std::size_t col = 0U; col < dim; ++col) {
+                auto  w = value(e.w);
+                auto* n = e.p;
+                for (auto q = static_cast<dd::Qubit>(k - 1U); q >= 0 && w != 0.; --q) {
+                    const auto r = (row >> static_cast<std::size_t>(q)) & 1U;
+                    const auto c = (col >> static_cast<std::size_t>(q)) & 1U;
+                    if (dd::Package::mNode::isTerminal(n) || n->v != q) {
+                        // skipped levels act as identity
+                        w = (r == c) ? w : 0.;
+                        continue;
+                    }
+                    const auto& child = n->e[2U * r + c];
+                    w *= value(child.w);
+                    n = child.p;
+                }
+                matrix[row * dim + col] = w;
+            }
+        }
+        package->garbageCollect();
+        return matrix;
+    }
+
+    void DenseState::addGateMatrices(const qc::Operation& op, MatrixCache& matrices) {
+        if (op.isCompoundOperation()) {
+            for (const auto& sub: dynamic_cast<const qc::CompoundOperation&>(op)) {
+                addGateMatrices(*sub, matrices);
+            }
+            return;
+        }
+        // non-unitary operations are rejected and uncontrolled SWAPs are not applied by apply
+        if (!op.isUnitary() || (op.getType() == qc::SWAP && !op.isControlled())) {
+            return;
+        }
+        matrices.try_emplace(&op, gateMatrix(op));
+    }
+
+    void DenseState::apply(const qc::Operation& op, qc::Permutation& permutation, const MatrixCache* matrices) {
+        if (op.isCompoundOperation()) {
+            for (const auto& sub: dynamic_cast<const qc::CompoundOperation&>(op)) {
+                apply(*sub, permutation, matrices);
+            }
+            return;
+        }
+        if (!op.isUnitary()) {
+            const auto type = op.getType();
+            if (type == qc::Barrier || type == qc::Snapshot || type == qc::ShowProbabilities) {
+                return;
+            }
+            throw std::invalid_argument("Operation " + op.getName() + " is not supported by dense simulation.");
+        }
+
+        const auto& targets = op.getTargets();
+        if (op.getType() == qc::SWAP && !op.isControlled()) {
+            std::swap(permutation.at(targets.at(0)), permutation.at(targets.at(1)));
+            return;
+        }
+
+        std::vector<std::size_t> mapped{};
+        for (const auto target: targets) {
+            mapped.emplace_back(static_cast<std::size_t>(permutation.at(target)));
+        }
+        std::vector<std::size_t> positive{};
+        std::vector<std::size_t> negative{};
+        for (const auto& control: op.getControls()) {
+            (control.type == dd::Control::Type::pos ? positive : negative).emplace_back(static_cast<std::size_t>(permutation.at(control.qubit)));
+        }
+        if (matrices != nullptr) {
+            if (const auto it = matrices->find(&op); it != matrices->end()) {
+                apply(it->second, mapped, positive, negative);
+                return;
+            }
+        }
+        apply(gateMatrix(op), mapped, positive, negative);
+    }
+
+    void DenseState::apply(const Matrix& matrix, const std::vector<std::size_t>& targets, const std::vector<std::size_t>& positive, const std::vector<std::size_t>& negative) {
+        std::vector<std::size_t> qubits = targets;
+        qubits.insert(qubits.end(), positive.begin(), positive.end());
+        qubits.insert(qubits.end(), negative.begin(), negative.end());
+        std::uint64_t set = 0U;
+        for (const auto q: positive) {
+            set |= std::uint64_t{1} << q;
+        }
+
+        auto* const r = re.data();
+        auto* const i = im.data();
+        if (targets.size() == 1U) {
+            const auto stride = std::uint64_t{1} << targets.front();
+            const auto m00r = matrix[0].real(), m00i = matrix[0].imag(), m01r = matrix[1].real(), m01i = matrix[1].imag();
+            const auto m10r = matrix[2].real(), m10i = matrix[2].imag(), m11r = matrix[3].real(), m11i = matrix[3].imag();
+
+            if (matrix[1] == 0. && matrix[2] == 0.) {
+                // diagonal gates (phases, Z rotations, ...) act on every amplitude independently
+                forEachBlock(nqubits, nthreads, qubits, set, [&](std::uint64_t base, std::uint64_t run) {
+                    for (std::uint64_t j = base; j < base + run; ++j) {
+                        const auto ar = r[j], ai = i[j], br = r[j + stride], bi = i[j + stride];
+                        r[j]          = m00r * ar - m00i * ai;
+                        i[j]          = m00r * ai + m00i * ar;
+                        r[j + stride] = m11r * br - m11i * bi;
+                        i[j + stride] = m11r * bi + m11i * br;
+                    }
+                });
+                return;
+            }
+
+            forEachBlock(nqubits, nthreads, qubits, set, [&](std::uint64_t base, std::uint64_t run) {
+                for (std::uint64_t j = base; j < base + run; ++j) {
+                    const auto ar = r[j], ai = i[j], br = r[j + stride], bi = i[j + stride];
+                    r[j]          = m00r * ar - m00i * ai + m01r * br - m01i * bi;
+                    i[j]          = m00r * ai + m00i * ar + m01r * bi + m01i * br;
+                    r[j + stride] = m10r * ar - m10i * ai + m11r * br - m11i * bi;
+                    i[j + stride] = m10r * ai + m10i * ar + m11r * bi + m11i * br;
+                }
+            });
+            return;
+        }
+
+        // general case: gather the 2^k amplitudes of every block of targets, multiply, and scatter them back
+        const auto                 dim = std::size_t{1} << targets.size();
+        std::vector<std::uint64_t> offsets(dim);
+        for (std::size_t s = 0U; s < dim; ++s) {
+            for (std::size_t t = 0U; t < targets.size(); ++t) {
+                if (((s >> t) & 1U) != 0U) {
+                    offsets[s] |= std::uint64_t{1} << targets[t];
+                }
+            }
+        }
+        forEachBlock(nqubits, nthreads, qubits, set, [&](std::uint64_t base, std::uint64_t run) {
+            std::vector<std::complex<dd::fp>> in(dim);
+            for (std::uint64_t j = base; j < base + run; ++j) {
+                for (std::size_t s = 0U; s < dim; ++s) {
+                    in[s] = {r[j + offsets[s]], i[j + offsets[s]]};
+                }
+                for (std::size_t row = 0U; row < dim; ++row) {
+                    std::complex<dd::fp> out = 0.;
+                    for (std::size_t col = 0U; col < dim; ++col) {
+                        out += matrix[row * dim + col] * in[col];
+                    }
+                    r[j + offsets[row]] = out.real();
+                    i[j + offsets[row]] = out.imag();
+                }
+            }
+        });
+    }
+
+    void DenseState::swap(std::size_t q0, std::size_t q1) {
+        if (q0 == q1) {
+            return;
+        }
+        const auto s0 = std::uint64_t{1} << q0;
+        const auto s1 = std::uint64_t{1} << q1;
+        forEachBlock(nqubits, nthreads, {q0, q1}, s0, [&](std::uint64_t base, std::uint64_t run) {
+            // base has q0 set and q1 unset, its partner vice versa
+            std::swap_ranges(re.begin() + static_cast<std::ptrdiff_t>(base), re.begin() + static_cast<std::ptrdiff_t>(base + run), re.begin() + static_cast<std::ptrdiff_t>(base - s0 + s1));
+            std::swap_ranges(im.begin() + static_cast<std::ptrdiff_t>(base), im.begin() + static_cast<std::ptrdiff_t>(base + run), im.begin() + static_cast<std::ptrdiff_t>(base - s0 + s1));
+        });
+    }
+
+    void DenseState::changePermutation(qc::Permutation& from, const qc::Permutation& to) {
+        for (const auto& [i, goal]: to) {
+            auto it = from.find(i);
+            if (it == from.end()) {
+                throw std::runtime_error("Key " + std::to_string(i) + " was not found in first permutation. This should never happen.");
+            }
+            const auto current = it->second;
+            if (current == goal) {
+                continue;
+            }
+            auto it2 = std::find_if(from.begin(), from.end(), [&goal](const auto& x) { return x.second == goal; });
+            if (it2 == from.end()) {
+                throw std::runtime_error("Value " + std::to_string(goal) + " was not found in first permutation. This should never happen.");
+            }
+            const auto j = it2->first;
+            swap(static_cast<std::size_t>(current), static_cast<std::size_t>(goal));
+            from.at(i) = goal;
+            from.at(j) = current;
+        }
+    }
+
+    void DenseState::reduceGarbage(const std::vector<bool>& garbage) {
+        for (std::size_t q = 0U; q < garbage.size() && q < nqubits; ++q) {
+            if (!garbage[q]) {
+                continue;
+            }
+            const auto stride = std::uint64_t{1} << q;
+            forEachBlock(nqubits, nthreads, {q}, 0U, [&](std::uint64_t base, std::uint64_t run) {
+                for (std::uint64_t j = base; j < base + run; ++j) {
+                    re[j] += re[j + stride];
+                    im[j] += im[j + stride];
+                    re[j + stride] = 0.;
+                    im[j + stride] = 0.;
+                }
+            });
+        }
+    }
+
+    std::complex<dd::fp> DenseState::innerProduct(const DenseState& other) const {
+        if (other.nqubits != nqubits) {
+            throw std::invalid_argument("Dense states of different sizes.");
+        }
+        // partial sums per chunk (the chunks of parallelFor are at most nthreads)
+        const auto                        n      = static_cast<std::uint64_t>(re.size());
+        const auto                        chunks = std::max<std::uint64_t>(1U, std::min<std::uint64_t>(nthreads, n));
+        std::vector<std::complex<dd::fp>> partial(chunks);
+        parallelFor(chunks, nthreads, n, [&](std::uint64_t begin, std::uint64_t end) {
+            for (auto c = begin; c < end; ++c) {
+                dd::fp     sr    = 0.;
+                dd::fp     si    = 0.;
+                const auto first = n * c / chunks;
+                const auto last  = n * (c + 1U) / chunks;
+                for (auto j = first; j < last; ++j) {
+                    sr += re[j] * other.re[j] + im[j] * other.im[j];
+                    si += re[j] * other.im[j] - im[j] * other.re[j];
+                }
+                partial[c] = {sr, si};
+            }
+        });
+        std::complex<dd::fp> sum = 0.;
+        for (const auto& p: partial) {
+            sum += p;
+        }
+        return sum;
+    }
+
+    dd::fp DenseState::fidelity(const DenseState& other) const {
+        return std::norm(innerProduct(other));
+    }
+} // namespace ec
@@ -5,9 +5,176 @@
 
 #include "EquivalenceChecker.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <fstream>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
 namespace ec {
 
+    std::mutex              ToleranceGuard::mutex{};
+    std::condition_variable ToleranceGuard::released{};
+    std::size_t             ToleranceGuard::active  = 0U;
+    std::size_t             ToleranceGuard::next    = 0U;
+    std::size_t             ToleranceGuard::serving = 0U;
+    dd::fp                  ToleranceGuard::current = dd::ComplexTable<>::tolerance();
+
+    ToleranceGuard::ToleranceGuard(dd::fp tolerance) {
+        std::unique_lock lock(mutex);
+        const auto       ticket = next++;
+        released.wait(lock, [&]() { return ticket == serving && (active == 0U || current == tolerance); });
+        if (active == 0U && current != tolerance) {
+            dd::ComplexTable<>::setTolerance(tolerance);
+            current = tolerance;
+        }
+        ++active;
+        // the next ticket may share the tolerance and enter right away
+        ++serving;
+        released.notify_all();
+    }
+
+    ToleranceGuard::~ToleranceGuard() {
+        std::lock_guard lock(mutex);
+        if (--active == 0U) {
+            released.notify_all();
+        }
+    }
+
+    GarbageCollector::GarbageCollector(const Configuration& config):
+        policy(config.garbageCollectionPolicy) {
+        switch (policy) {
+            case GarbageCollectionPolicy::NodeThreshold:
+                minimum = config.gcNodeThreshold;
+                break;
+            case GarbageCollectionPolicy::MemoryBudget:
+                minimum = config.gcMemoryBudget / 10U * 9U;
+                release = config.gcMemoryBudget / 10U * 8U;
+                break;
+            case GarbageCollectionPolicy::Interval:
+                minimum = std::max<std::size_t>(config.gcInterval, 1U);
+                break;
+            default:
+                break;
+        }
+        trigger = minimum;
+    }
+
+    std::size_t GarbageCollector::usage(const dd::Package& dd) const {
+        const auto vNodes = dd.vUniqueTable.getNodeCount();
+        const auto mNodes = dd.mUniqueTable.getNodeCount();
+        if (policy == GarbageCollectionPolicy::MemoryBudget) {
+            return vNodes * sizeof(dd::Package::vNode) + mNodes * sizeof(dd::Package::mNode);
+        }
+        return vNodes + mNodes;
+    }
+
+    void GarbageCollector::collect(dd::Package& dd) {
+        const auto nodes = dd.vUniqueTable.getNodeCount() + dd.mUniqueTable.getNodeCount();
+        peakNodes        = std::max(peakNodes, nodes);
+
+        switch (policy) {
+            case GarbageCollectionPolicy::PerGate:
+                // a no-op unless one of the tables has reached its internal limit (as the unforced collection of the package)
+                if (!dd.vUniqueTable.possiblyNeedsCollection() && !dd.mUniqueTable.possiblyNeedsCollection() && !dd.cn.complexTable.possiblyNeedsCollection()) {
+                    return;
+                }
+                break;
+            case GarbageCollectionPolicy::NodeThreshold:
+                if (usage(dd) < trigger) {
+                    return;
+                }
+                break;
+            case GarbageCollectionPolicy::MemoryBudget:
+                if (usage(dd) < trigger || ++gates < backoff) {
+                    return;
+                }
+                gates = 0U;
+                break;
+            case GarbageCollectionPolicy::Interval:
+                if (++gates < trigger) {
+                    return;
+                }
+                gates = 0U;
+                break;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        dd.garbageCollect(policy != GarbageCollectionPolicy::PerGate);
+        const auto                          remaining = dd.vUniqueTable.getNodeCount() + dd.mUniqueTable.getNodeCount();
+        const std::chrono::duration<double> duration  = std::chrono::steady_clock::now() - start;
+
+        ++collections;
+        time += duration.count();
+        reclaimed += (nodes > remaining) ? nodes - remaining : 0U;
+        if (policy == GarbageCollectionPolicy::NodeThreshold) {
+            trigger = std::max(minimum, 2U * usage(dd));
+        } else if (policy == GarbageCollectionPolicy::MemoryBudget) {
+            backoff = (usage(dd) < release) ? 0U : std::min(std::max<std::size_t>(2U * backoff, 1U), MAX_BACKOFF);
+        }
+    }
+
+    ResourceLimits::ResourceLimits(const Configuration& config):
+        maxActiveNodes(config.maxActiveNodes), maxResidentMemory(config.maxResidentMemory) {}
+
+    bool ResourceLimits::exceeded(const dd::Package& dd) {
+        if (hit) {
+            return true;
+        }
+        if (maxActiveNodes > 0U && dd.vUniqueTable.getActiveNodeCount() + dd.mUniqueTable.getActiveNodeCount() > maxActiveNodes) {
+            hit    = true;
+            reason = "active nodes";
+        } else if (maxResidentMemory > 0U && ++gates % MEMORY_CHECK_INTERVAL == 0U) {
+            const auto memory  = residentMemory();
+            peakResidentMemory = std::max(peakResidentMemory, memory);
+            if (memory > maxResidentMemory) {
+                hit    = true;
+                reason = "resident memory";
+            }
+        }
+        return hit;
+    }
+
+    void ResourceLimits::merge(const ResourceLimits& other) {
+        if (!hit && other.hit) {
+            hit    = true;
+            reason = other.reason;
+        }
+        peakResidentMemory = std::max(peakResidentMemory, other.peakResidentMemory);
+    }
+
+    std::size_t ResourceLimits::residentMemory() {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        std::size_t   size     = 0U;
+        std::size_t   resident = 0U;
+        if (statm >> size >> resident) {
+            return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        }
+        return 0U;
+#elif defined(__APPLE__)
+        mach_task_basic_info_data_t info{};
+        mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+            return static_cast<std::size_t>(info.resident_size);
+        }
+        return 0U;
+#else
+        return 0U;
+#endif
+    }
+
+    void GarbageCollector::merge(const GarbageCollector& other) {
+        collections += other.collections;
+        time += other.time;
+        reclaimed += other.reclaimed;
+        peakNodes = std::max(peakNodes, other.peakNodes);
+    }
+
     EquivalenceChecker::EquivalenceChecker(qc::QuantumComputation& qc1, qc::QuantumComputation& qc2):
         qc1(qc1), qc2(qc2) {
         // currently this modifies the underlying quantum circuits
@@ -168,6 +335,7 @@ namespace ec {
     }
 
     EquivalenceCheckingResults EquivalenceChecker::check(const Configuration& config) {
+        ToleranceGuard             guard(config.tolerance);
         EquivalenceCheckingResults results{};
         setupResults(results);
 
@@ -180,7 +348,7 @@ namespace ec {
         dd->incRef(e);
         e = dd->reduceAncillae(e, ancillary1);
 
-        while (it1 != end1) {
+        while (it1 != end1 && !resourceLimits.hit) {
             applyGate(qc1, it1, e, perm1);
             ++it1;
         }
@@ -193,7 +361,7 @@ namespace ec {
         dd->incRef(f);
         f = dd->reduceAncillae(f, ancillary2);
 
-        while (it2 != end2) {
+        while (it2 != end2 && !resourceLimits.hit) {
             applyGate(qc2, it2, f, perm2);
             ++it2;
         }
@@ -202,9 +370,15 @@ namespace ec {
         f = dd->reduceGarbage(f, garbage2);
 
         results.maxActive = dd->mUniqueTable.getMaxActiveNodes();
+        limitGates1       = static_cast<std::size_t>(std::distance(qc1.begin(), it1));
+        limitGates2       = static_cast<std::size_t>(std::distance(qc2.begin(), it2));
 
         results.equivalence = equals(e, f);
-        if (results.equivalence == Equivalence::NotEquivalent) {
+        storeStatistics(results);
+        if (resourceLimits.hit) {
+            dd->decRef(e);
+            dd->decRef(f);
+        } else if (results.equivalence == Equivalence::NotEquivalent) {
             results.result = dd->multiply(e, dd->conjugateTranspose(f));
             dd->decRef(e);
             dd->decRef(f);
@@ -223,9 +397,115 @@ namespace ec {
         return results;
     }
 
-    void EquivalenceChecker::runPreCheckPasses(const Configuration& config) {
-        setTolerance(config.tolerance);
+    std::size_t EquivalenceChecker::GateCacheKeyHash::operator()(const GateCacheKey& key) const {
+        auto h = std::hash<const qc::Operation*>{}(key.op);
+        h ^= static_cast<std::size_t>(key.type) + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+        h ^= static_cast<std::size_t>(key.dir) + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+        for (const auto q: key.qubits) {
+            h ^= static_cast<std::size_t>(q) + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+        }
+        return h;
+    }
+
+    qc::MatrixDD EquivalenceChecker::getGateDD(std::unique_ptr<qc::Operation>& op, qc::Permutation& permutation, Direction dir) {
+        // set appropriate qubit count to generate correct DD
+        auto nq = op->getNqubits();
+        op->setNqubits(nqubits);
+
+        GateCacheKey key{op.get(), op->getType(), dir, {}};
+        if (useGateCache) {
+            if (op->isCompoundOperation()) {
+                // the qubits of a compound operation are only known to its constituents
+                for (const auto& [logical, physical]: permutation) {
+                    key.qubits.push_back(physical);
+                }
+            } else {
+                for (const auto& target: op->getTargets()) {
+                    key.qubits.push_back(permutation.at(target));
+                }
+                for (const auto& control: op->getControls()) {
+                    key.qubits.push_back(permutation.at(control.qubit));
+                }
+            }
+            if (auto it = gateCache.find(key); it != gateCache.end()) {
+                ++gateCacheHits;
+                op->setNqubits(nq);
+                return it->second;
+            }
+            ++gateCacheMisses;
+        }
+
+        const auto before = permutation;
+        auto       e      = (dir == LEFT) ? op->getDD(dd, permutation) : op->getInverseDD(dd, permutation);
+        // operations which alter the permutation cannot be replayed from the cache
+        if (useGateCache && permutation == before) {
+            dd->incRef(e);
+            gateCache.emplace(std::move(key), e);
+        }
+
+        // reset qubit count
+        op->setNqubits(nq);
+        return e;
+    }
+
+    void EquivalenceChecker::setupGateCache(const Configuration& config) {
+        useGateCache    = config.cacheGateDDs;
+        gateCacheHits   = 0U;
+        gateCacheMisses = 0U;
 
+        std::vector<const qc::Operation*> ops{};
+        ops.reserve(qc1.getNops() + qc2.getNops());
+        for (const auto& op: qc1) {
+            ops.emplace_back(op.get());
+        }
+        for (const auto& op: qc2) {
+            ops.emplace_back(op.get());
+        }
+        if (!useGateCache || ops != gateCacheOps) {
+            clearGateCache();
+        }
+        gateCacheOps = std::move(ops);
+    }
+
+    void EquivalenceChecker::clearGateCache() {
+        for (auto& [key, e]: gateCache) {
+            dd->decRef(e);
+        }
+        gateCache.clear();
+    }
+
+    void EquivalenceChecker::storeStatistics(EquivalenceCheckingResults& results) const {
+        results.gateCacheHits += gateCacheHits;
+        results.gateCacheMisses += gateCacheMisses;
+        results.gcCollections    = garbageCollector.collections;
+        results.gcTime           = garbageCollector.time;
+        results.gcReclaimedNodes = garbageCollector.reclaimed;
+        results.gcPeakNodes      = garbageCollector.peakNodes;
+        if (resourceLimits.hit) {
+            // whatever has been computed so far does not allow any conclusion
+            results.equivalence        = Equivalence::NoInformation;
+            results.limitExceeded      = true;
+            results.limitReason        = resourceLimits.reason;
+            results.limitGates1        = limitGates1;
+            results.limitGates2        = limitGates2;
+            results.peakResidentMemory = resourceLimits.peakResidentMemory;
+        }
+        if (miterCancelled) {
+            results.miterCancelled       = true;
+            results.miterRemovedGates1   = miterStatistics.removedGates1;
+            results.miterRemovedGates2   = miterStatistics.removedGates2;
+            results.miterMergedRotations = miterStatistics.mergedRotations;
+        }
+        if (commonGatesStripped) {
+            results.commonGatesStripped = true;
+            results.strippedPrefix      = strippingStatistics.strippedPrefix;
+            results.strippedSuffix      = strippingStatistics.strippedSuffix;
+            results.remainingGates1     = strippingStatistics.remainingGates1;
+            results.remainingGates2     = strippingStatistics.remainingGates2;
+        }
+    }
+
+    void EquivalenceChecker::runPreCheckPasses(const Configuration& config) {
         if (config.removeDiagonalGatesBeforeMeasure) {
             qc::CircuitOptimizer::removeDiagonalGatesBeforeMeasure(qc1);
             qc::CircuitOptimizer::removeDiagonalGatesBeforeMeasure(qc2);
@@ -236,11 +516,38 @@ namespace ec {
             qc::CircuitOptimizer::swapReconstruction(qc2);
         }
 
+        // before gates are fused into compound operations which are not cancelled
+        if (config.cancelMiterGates) {
+            std::vector<bool> garbage(nqubits);
+            for (std::size_t q = 0U; q < garbage.size(); ++q) {
+                garbage[q] = (q < garbage1.size() && garbage1[q]) || (q < garbage2.size() && garbage2[q]);
+            }
+            miterStatistics = cancelMiterGates(qc1, initial1, output1, qc2, initial2, output2, garbage, nqubits, config.tolerance);
+            miterCancelled  = true;
+        }
+
+        if (config.stripCommonGates) {
+            std::vector<bool> ancillary(nqubits);
+            std::vector<bool> garbage(nqubits);
+            for (std::size_t q = 0U; q < nqubits; ++q) {
+                ancillary[q] = (q < ancillary1.size() && ancillary1[q]) || (q < ancillary2.size() && ancillary2[q]);
+                garbage[q]   = (q < garbage1.size() && garbage1[q]) || (q < garbage2.size() && garbage2[q]);
+            }
+            strippingStatistics = stripCommonGates(qc1, initial1, output1, qc2, initial2, output2, ancillary, garbage, config.tolerance);
+            commonGatesStripped = true;
+        }
+
         if (config.fuseSingleQubitGates) {
             qc::CircuitOptimizer::singleQubitGateFusion(qc1);
             qc::CircuitOptimizer::singleQubitGateFusion(qc2);
         }
 
+        setupGateCache(config);
+        garbageCollector = GarbageCollector(config);
+        resourceLimits   = ResourceLimits(config);
+        limitGates1      = 0U;
+        limitGates2      = 0U;
+
         it1  = qc1.begin();
         it2  = qc2.begin();
         end1 = qc1.cend();
@@ -15,6 +15,8 @@ namespace ec {
                 return "G -> I <- G'";
             case Method::Simulation:
                 return "simulation";
+            case Method::Stabilizer:
+                return "stabilizer";
         }
         return " ";
     }
@@ -45,6 +47,12 @@ namespace ec {
                 return "lookahead";
             case Strategy::CompilationFlow:
                 return "compilation flow";
+            case Strategy::BeamLookahead:
+                return "beam lookahead";
+            case Strategy::SizeFeedback:
+                return "size feedback";
+            case Strategy::Commutation:
+                return "commutation";
         }
         return " ";
     }
@@ -61,6 +69,32 @@ namespace ec {
         return " ";
     }
 
+    std::string toString(const SimulationBackend& backend) {
+        switch (backend) {
+            case SimulationBackend::DecisionDiagram:
+                return "decision diagram";
+            case SimulationBackend::Dense:
+                return "dense";
+            case SimulationBackend::Adaptive:
+                return "adaptive";
+        }
+        return " ";
+    }
+
+    std::string toString(const GarbageCollectionPolicy& policy) {
+        switch (policy) {
+            case GarbageCollectionPolicy::PerGate:
+                return "per gate";
+            case GarbageCollectionPolicy::NodeThreshold:
+                return "node threshold";
+            case GarbageCollectionPolicy::MemoryBudget:
+                return "memory budget";
+            case GarbageCollectionPolicy::Interval:
+                return "interval";
+        }
+        return " ";
+    }
+
     std::ostream& EquivalenceCheckingResults::print(std::ostream& out) const {
         out << "[" << verificationTime;
         if (preprocessingTime > 1e-4) {
@@ -69,6 +103,12 @@ namespace ec {
         out << "]\t";
         if (equivalence == Equivalence::NoInformation) {
             out << "No information on the equivalence of " << name;
+            if (heuristicallyAborted) {
+                out << " (heuristically aborted after " << abortGateIndex << " gates at sampled fidelity " << abortFidelity << ")";
+            }
+            if (limitExceeded) {
+                out << " (" << limitReason << " limit exceeded after " << limitGates1 << " | " << limitGates2 << " gates)";
+            }
         } else if (equivalence == Equivalence::Equivalent) {
             out << "Shown " << name << " equivalent";
         } else if (equivalence == Equivalence::NotEquivalent) {
@@ -77,10 +117,20 @@ namespace ec {
                 out << " (performed " << nsims << " sims using " << ec::toString(stimuliType) << " stimuli)";
             }
         } else if (equivalence == Equivalence::ProbablyEquivalent) {
-            out << "Suggesting " << name << " to be-equivalent (performed " << nsims << " sims)";
+            out << "Suggesting " << name << " to be-equivalent (performed " << nsims << " sims";
+            if (adaptiveStimuli) {
+                out << ", assumed confidence " << equivalenceConfidence;
+            }
+            out << ")";
         } else if (equivalence == Equivalence::EquivalentUpToGlobalPhase) {
             out << "Shown " << name << " equivalent up to global phase";
         }
+        if (approximated) {
+            out << " with an approximated fidelity of " << fidelity << " (exact fidelity in [" << fidelityLowerBound << ", " << fidelityUpperBound << "] after " << approximations << " approximations)";
+        }
+        if (fidelityEstimated) {
+            out << " with an estimated fidelity of " << fidelityEstimate << " in [" << ciLow << ", " << ciHigh << "]";
+        }
         out << " with the " << ec::toString(method) << " method (";
         if (method == Method::G_I_Gp) {
             out << "using the " << ec::toString(strategy) << " strategy ";
@@ -101,6 +151,10 @@ namespace ec {
         } else {
             ss << ";;";
         }
+        ss << ";";
+        if (adaptiveStimuli) {
+            ss << equivalenceConfidence;
+        }
         return ss.str();
     }
 
@@ -125,11 +179,100 @@ namespace ec {
         stats["verification_time"]  = verificationTime;
         stats["max_nodes"]          = maxActive;
         stats["method"]             = ec::toString(method);
+        if (miterCancelled) {
+            stats["miter_cancellation"]     = {};
+            auto& miter                     = stats["miter_cancellation"];
+            miter["removed_gates_circuit1"] = miterRemovedGates1;
+            miter["removed_gates_circuit2"] = miterRemovedGates2;
+            miter["merged_rotations"]       = miterMergedRotations;
+        }
+        if (commonGatesStripped) {
+            stats["common_gate_stripping"]        = {};
+            auto& stripping                       = stats["common_gate_stripping"];
+            stripping["stripped_prefix"]          = strippedPrefix;
+            stripping["stripped_suffix"]          = strippedSuffix;
+            stripping["remaining_gates_circuit1"] = remainingGates1;
+            stripping["remaining_gates_circuit2"] = remainingGates2;
+        }
+        if (limitExceeded) {
+            stats["resource_limit"]       = {};
+            auto& limit                   = stats["resource_limit"];
+            limit["exceeded"]             = limitReason;
+            limit["gates_circuit1"]       = limitGates1;
+            limit["gates_circuit2"]       = limitGates2;
+            limit["peak_resident_memory"] = peakResidentMemory;
+        }
+        if (gcCollections > 0) {
+            stats["garbage_collection"] = {};
+            auto& gc                    = stats["garbage_collection"];
+            gc["collections"]           = gcCollections;
+            gc["time"]                  = gcTime;
+            gc["reclaimed_nodes"]       = gcReclaimedNodes;
+            gc["peak_nodes"]            = gcPeakNodes;
+        }
+        if (gateCacheHits + gateCacheMisses > 0) {
+            stats["gate_cache"] = {};
+            auto& gateCache     = stats["gate_cache"];
+            gateCache["hits"]   = gateCacheHits;
+            gateCache["misses"] = gateCacheMisses;
+        }
         if (method == Method::Simulation) {
             stats["n_sims"]       = nsims;
             stats["stimuli_type"] = ec::toString(stimuliType);
+            if (guidedQubits > 0) {
+                stats["guided_qubits"] = guidedQubits;
+            }
+            if (adaptiveStimuli) {
+                stats["assumed_confidence"]                    = equivalenceConfidence;
+                stats["sims_per_stimuli_type"]                 = {};
+                auto& sims                                     = stats["sims_per_stimuli_type"];
+                sims[ec::toString(StimuliType::Classical)]     = simsPerStimuliType[static_cast<std::size_t>(StimuliType::Classical)];
+                sims[ec::toString(StimuliType::LocalQuantum)]  = simsPerStimuliType[static_cast<std::size_t>(StimuliType::LocalQuantum)];
+                sims[ec::toString(StimuliType::GlobalQuantum)] = simsPerStimuliType[static_cast<std::size_t>(StimuliType::GlobalQuantum)];
+            }
+            if (peakStateMemory > 0) {
+                stats["adaptive_backend"]    = {};
+                auto& backend                = stats["adaptive_backend"];
+                backend["dense_switches"]    = denseSwitches;
+                backend["switch_gate"]       = denseSwitchGate;
+                backend["conversion_time"]   = denseConversionTime;
+                backend["peak_state_memory"] = peakStateMemory;
+            }
+            if (approximated) {
+                stats["approximation"]                = {};
+                auto& approximation                   = stats["approximation"];
+                approximation["fidelity"]             = fidelity;
+                approximation["fidelity_lower_bound"] = fidelityLowerBound;
+                approximation["fidelity_upper_bound"] = fidelityUpperBound;
+                approximation["rounds"]               = approximations;
+                approximation["peak_nodes"]           = approximationPeakNodes;
+            }
+            if (simulationCacheHits + simulationCacheMisses > 0) {
+                stats["simulation_cache"] = {};
+                auto& simulationCache     = stats["simulation_cache"];
+                simulationCache["hits"]   = simulationCacheHits;
+                simulationCache["misses"] = simulationCacheMisses;
+            }
+            if (fidelityEstimated) {
+                stats["fidelity_estimate"] = fidelityEstimate;
+                stats["ci_low"]            = ciLow;
+                stats["ci_high"]           = ciHigh;
+            }
         } else if (method == Method::G_I_Gp) {
             stats["strategy"] = ec::toString(strategy);
+            if (traceComputed) {
+                stats["trace"]            = std::pair{trace.real(), trace.imag()};
+                stats["process_fidelity"] = processFidelity;
+            }
+            if (heuristicallyAborted) {
+                stats["heuristic_abort"]      = {};
+                auto& heuristic               = stats["heuristic_abort"];
+                heuristic["aborted"]          = true;
+                heuristic["gate_index"]       = abortGateIndex;
+                heuristic["gates_circuit1"]   = abortGates1;
+                heuristic["gates_circuit2"]   = abortGates2;
+                heuristic["sampled_fidelity"] = abortFidelity;
+            }
         }
 
         if (method == Method::Simulation) {
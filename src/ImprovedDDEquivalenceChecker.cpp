@@ -6,6 +6,89 @@
 #include <ImprovedDDEquivalenceChecker.hpp>
 
 namespace ec {
+    namespace {
+        /// Number of nodes on every level of the matrix DD
+        std::vector<double> levelWidths(const qc::MatrixDD& e, dd::QubitCount nqubits) {
+            std::vector<double>                            widths(nqubits, 0.);
+            std::unordered_set<const dd::Package::mNode*> visited{};
+            std::vector<const dd::Package::mNode*>         stack{e.p};
+            while (!stack.empty()) {
+                const auto* p = stack.back();
+                stack.pop_back();
+                if (dd::Package::mNode::isTerminal(p) || !visited.insert(p).second) {
+                    continue;
+                }
+                widths.at(static_cast<std::size_t>(p->v)) += 1.;
+                for (const auto& child: p->e) {
+                    stack.push_back(child.p);
+                }
+            }
+            return widths;
+        }
+
+        /// Levels of the DD the operation acts on under the given permutation
+        std::vector<std::size_t> supportLevels(const qc::Operation& op, const qc::Permutation& permutation) {
+            std::vector<std::size_t> levels{};
+            if (op.isCompoundOperation()) {
+                for (const auto& [logical, physical]: permutation) {
+                    if (op.actsOn(logical)) {
+                        levels.emplace_back(static_cast<std::size_t>(physical));
+                    }
+                }
+                return levels;
+            }
+            for (const auto& target: op.getTargets()) {
+                levels.emplace_back(static_cast<std::size_t>(permutation.at(target)));
+            }
+            for (const auto& control: op.getControls()) {
+                levels.emplace_back(static_cast<std::size_t>(permutation.at(control.qubit)));
+            }
+            return levels;
+        }
+
+        /// Whether both operations are the same gate acting on the same levels of the DD, i.e., applying the first one from LEFT
+        /// and the second one from RIGHT cancels
+        bool cancels(const qc::Operation& op1, const qc::Permutation& perm1, const qc::Operation& op2, const qc::Permutation& perm2) {
+            if (!op1.isStandardOperation() || !op2.isStandardOperation() || !op1.isUnitary() || !op2.isUnitary() ||
+                op1.getType() != op2.getType() || op1.getTargets().size() != op2.getTargets().size() || op1.getControls().size() != op2.getControls().size()) {
+                return false;
+            }
+            for (std::size_t i = 0U; i < op1.getTargets().size(); ++i) {
+                if (perm1.at(op1.getTargets()[i]) != perm2.at(op2.getTargets()[i])) {
+                    return false;
+                }
+            }
+            std::vector<std::pair<dd::Qubit, dd::Control::Type>> controls1{};
+            std::vector<std::pair<dd::Qubit, dd::Control::Type>> controls2{};
+            for (const auto& control: op1.getControls()) {
+                controls1.emplace_back(perm1.at(control.qubit), control.type);
+            }
+            for (const auto& control: op2.getControls()) {
+                controls2.emplace_back(perm2.at(control.qubit), control.type);
+            }
+            std::sort(controls1.begin(), controls1.end());
+            std::sort(controls2.begin(), controls2.end());
+            if (controls1 != controls2) {
+                return false;
+            }
+            for (std::size_t i = 0U; i < op1.getParameter().size(); ++i) {
+                if (std::abs(op1.getParameter()[i] - op2.getParameter()[i]) > dd::ComplexTable<>::tolerance()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Gates applied from the left are undone by gates applied from the right (and vice versa). The balance of a level counts
+        /// the gates applied from the left minus those applied from the right.
+        /// \return true if the application brought the balance of the level closer to zero
+        bool updateBalance(std::vector<std::int64_t>& balance, std::size_t level, Direction dir) {
+            const auto before = std::abs(balance[level]);
+            balance[level] += (dir == LEFT) ? 1 : -1;
+            return std::abs(balance[level]) < before;
+        }
+    } // namespace
+
     qc::MatrixDD ImprovedDDEquivalenceChecker::createInitialMatrix() {
         auto e = dd->makeIdent(nqubits);
         dd->incRef(e);
@@ -52,92 +135,44 @@ namespace ec {
         return goalMatrix;
     }
 
+    void ImprovedDDEquivalenceChecker::setupMonitor(const Configuration& config) {
+        fidelityMonitor                    = FidelityMonitor{};
+        fidelityMonitor.interval           = config.heuristicAbortInterval;
+        fidelityMonitor.nodeStep           = config.heuristicAbortNodeStep;
+        fidelityMonitor.threshold          = config.heuristicAbortThreshold;
+        fidelityMonitor.nextNodeCheckpoint = config.heuristicAbortNodeStep;
+    }
 
-
-    dd::fp* ImprovedDDEquivalenceChecker::traceRecur(dd::Package::mNode * cur, std::map<dd::Package::mNode *, dd::fp *> *Node_Table) {
-        // std::cout<<0<<std::endl;
-        std::map<dd::Package::mNode *, dd::fp *>::iterator it;
-        if (!(dd::Package::mNode::isTerminal(cur->e[0].p)) && (Node_Table->find(cur->e[0].p) == Node_Table->end()))
-        {
-            // std::cout<<1<<std::endl;
-            dd::fp * dum = traceRecur(cur->e[0].p, Node_Table);
-            // std::cout<<2<<std::endl;
-        }
-        if (!(dd::Package::mNode::isTerminal(cur->e[3].p)) && (Node_Table->find(cur->e[3].p) == Node_Table->end()))
-            dd::fp * dum = traceRecur(cur->e[3].p, Node_Table);
-
-        dd::fp * left;
-        dd::fp * right;
-        if (dd::Package::mNode::isTerminal(cur->e[0].p)) {
-            left = new dd::fp[2]; 
-            left[0] = 1.0;
-            left[1] = 0.0;
+    bool ImprovedDDEquivalenceChecker::monitor(const qc::MatrixDD& result) {
+        ++fidelityMonitor.appliedGates;
+        if (resourceLimits.hit) {
+            return true;
         }
-        else {
-            it = Node_Table->find(cur->e[0].p);
-            assert(it != Node_Table->end());
-            left = it->second;
-            // std::cout << "  left: " << left << std::endl;
+        if (!fidelityMonitor.enabled()) {
+            return false;
         }
-        if (dd::Package::mNode::isTerminal(cur->e[3].p)) {
-            right = new dd::fp[2]; 
-            right[0] = 1.0;
-            right[1] = 0.0;
+
+        bool checkpoint = fidelityMonitor.interval > 0U && fidelityMonitor.appliedGates % fidelityMonitor.interval == 0U;
+        if (fidelityMonitor.nodeStep > 0U) {
+            const auto size = dd->size(result);
+            if (size >= fidelityMonitor.nextNodeCheckpoint) {
+                checkpoint = true;
+                // the next checkpoint is the next multiple of the step beyond the current size
+                fidelityMonitor.nextNodeCheckpoint = (size / fidelityMonitor.nodeStep + 1U) * fidelityMonitor.nodeStep;
+            }
         }
-        else {
-            it = Node_Table->find(cur->e[3].p);
-            assert(it != Node_Table->end());
-            right = it->second;
-            // std::cout << "  right: " << right << std::endl;
+        if (!checkpoint) {
+            return false;
         }
-        // std::cout << "  wl: " << cur->e[0].w << std::endl;
-        // std::cout << "  wr: " << cur->e[3].w << std::endl;
-        dd::fp * w0 = complex2fp(cur->e[0].w);
-        dd::fp * w1 = complex2fp(cur->e[3].w);
-        dd::fp * le = mul(w0, left);
-        dd::fp * re = mul(w1, right);
-        // std::cout << "  le: " << le << std::endl;
-        // std::cout << "  re: " << re << std::endl;
-        dd::fp * sum = add(le, re);
-        (*Node_Table)[cur] = sum;
-        // std::cout << "  sum: " << sum << std::endl << std::endl;
-        // clear 
-        if (dd::Package::mNode::isTerminal(cur->e[0].p)) delete [] left;
-        if (dd::Package::mNode::isTerminal(cur->e[3].p)) delete [] right;
-        delete [] w0;
-        delete [] w1;
-        delete [] le;
-        delete [] re;
-        
-        return sum;
-    }
-
-    dd::fp * ImprovedDDEquivalenceChecker::complex2fp(const dd::Complex &c)
-    {
-        dd::fp * a = new dd::fp[2];
-        a[0] = dd::CTEntry::val(c.r);
-        a[1] = dd::CTEntry::val(c.i);
-        return a;
-    }
 
-    dd::fp * ImprovedDDEquivalenceChecker::add(dd::fp * a, dd::fp * b)
-    {
-        dd::fp * r = new dd::fp[2];
-        r[0] = a[0] + b[0];
-        r[1] = a[1] + b[1];
-        return r;
-    }
-
-    dd::fp * ImprovedDDEquivalenceChecker::mul(dd::fp * a, dd::fp * b)
-    {
-        dd::fp * r = new dd::fp[2];
-        r[0] = a[0] * b[0] - a[1] * b[1];
-        r[1] = a[0] * b[1] + a[1] * b[0];
-        return r;
+        fidelityMonitor.fidelity = TraceEngine::processFidelity(traceEngine.trace(result, nqubits), nqubits);
+        fidelityMonitor.aborted  = fidelityMonitor.fidelity < fidelityMonitor.threshold;
+        return fidelityMonitor.aborted;
     }
 
     /// Use dedicated method to check the equivalence of both provided circuits
     EquivalenceCheckingResults ImprovedDDEquivalenceChecker::check(const Configuration& config) {
+        ToleranceGuard             guard(config.tolerance);
         EquivalenceCheckingResults results{};
         setupResults(results);
         results.strategy = config.strategy;
@@ -149,6 +184,7 @@ namespace ec {
         auto perm1     = initial1;
         auto perm2     = initial2;
         results.result = createInitialMatrix();
+        setupMonitor(config);
 
         switch (config.strategy) {
             case ec::Strategy::Naive:
@@ -160,20 +196,53 @@ namespace ec {
             case ec::Strategy::Lookahead:
                 checkLookahead(results.result, perm1, perm2);
                 break;
+            case ec::Strategy::BeamLookahead:
+                checkBeamLookahead(results.result, perm1, perm2, config.lookaheadDepth, config.lookaheadBeamWidth);
+                break;
+            case ec::Strategy::SizeFeedback:
+                checkSizeFeedback(results.result, perm1, perm2, config.sizeFeedbackMaxImbalance);
+                break;
+            case ec::Strategy::Commutation:
+                checkCommutation(results.result, perm1, perm2);
+                break;
             default:
                 throw std::invalid_argument("Strategy " + toString(config.strategy) + " not supported by ImprovedDDEquivalenceChecker");
         }
 
         // finish first circuit
-        while (it1 != end1) {
+        while (it1 != end1 && !aborted()) {
             applyGate(qc1, it1, results.result, perm1, LEFT);
             ++it1;
+            monitor(results.result);
         }
 
         //finish second circuit
-        while (it2 != end2) {
+        while (it2 != end2 && !aborted()) {
             applyGate(qc2, it2, results.result, perm2, RIGHT);
             ++it2;
+            monitor(results.result);
+        }
+
+        if (aborted()) {
+            results.equivalence = Equivalence::NoInformation;
+            if (fidelityMonitor.aborted) {
+                results.heuristicallyAborted = true;
+                results.abortGateIndex       = fidelityMonitor.appliedGates;
+                results.abortGates1          = static_cast<std::size_t>(std::distance(qc1.begin(), it1));
+                results.abortGates2          = static_cast<std::size_t>(std::distance(qc2.begin(), it2));
+                results.abortFidelity        = fidelityMonitor.fidelity;
+            }
+            limitGates1       = static_cast<std::size_t>(std::distance(qc1.begin(), it1));
+            limitGates2       = static_cast<std::size_t>(std::distance(qc2.begin(), it2));
+            results.maxActive = std::max(results.maxActive, dd->mUniqueTable.getMaxActiveNodes());
+            storeStatistics(results);
+
+            auto                          endVerification   = std::chrono::steady_clock::now();
+            std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+            std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+            results.preprocessingTime                       = preprocessingTime.count();
+            results.verificationTime                        = verificationTime.count();
+            return results;
         }
 
         qc::QuantumComputation::changePermutation(results.result, perm1, output1, dd, LEFT);
@@ -183,26 +252,19 @@ namespace ec {
         results.result = dd->reduceAncillae(results.result, ancillary1, LEFT);
         results.result = dd->reduceAncillae(results.result, ancillary2, RIGHT);
 
-        // fidelity
-        if (isFid)
-        {
-            std::map<dd::Package::mNode *, dd::fp *> Node_Table;
-            std::map<dd::Package::mNode *, dd::fp *>::iterator it;
-            dd::fp * sum = traceRecur(results.result.p, &Node_Table);
-            dd::fp * w = complex2fp(results.result.w);
-            dd::fp * sum_w = mul(w, sum);
-            // std::cout << "  sum_w: " << sum_w << std::endl;
-            fid = (sum_w[0]*sum_w[0] + sum_w[1]*sum_w[1])/(pow(2, 2*nqubits));
-            std::cout << "  Fidelity: " << fid << std::endl;
-            // clear
-            delete [] w;
-            delete [] sum_w;
-            for (it = Node_Table.begin(); it != Node_Table.end(); it++) delete [] it->second;
-            Node_Table.clear();
+        if (config.computeFidelity) {
+            if (config.nthreads > 1) {
+                results.trace = traceEngine.traceParallel(results.result, nqubits, config.nthreads);
+            } else {
+                results.trace = traceEngine.trace(results.result, nqubits);
+            }
+            results.processFidelity = TraceEngine::processFidelity(results.trace, nqubits);
+            results.traceComputed   = true;
         }
 
         results.equivalence = equals(results.result, createGoalMatrix());
         results.maxActive   = std::max(results.maxActive, dd->mUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
 
         auto                          endVerification   = std::chrono::steady_clock::now();
         std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
@@ -215,11 +277,15 @@ namespace ec {
 
     /// Alternate between LEFT and RIGHT applications
     void ImprovedDDEquivalenceChecker::checkNaive(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2) {
-        while (it1 != end1 && it2 != end2) {
+        while (it1 != end1 && it2 != end2 && !aborted()) {
             applyGate(qc1, it1, result, perm1, LEFT);
             ++it1;
+            if (monitor(result)) {
+                break;
+            }
             applyGate(qc2, it2, result, perm2, RIGHT);
             ++it2;
+            monitor(result);
         }
     }
 
@@ -231,34 +297,162 @@ namespace ec {
         auto ratio1 = (qc1.getNops() > qc2.getNops()) ? ratio : 1;
         auto ratio2 = (qc1.getNops() > qc2.getNops()) ? 1 : ratio;
 
-        while (it1 != end1 && it2 != end2) {
-            for (unsigned int i = 0; i < ratio1 && it1 != end1; ++i) {
+        while (it1 != end1 && it2 != end2 && !aborted()) {
+            for (unsigned int i = 0; i < ratio1 && it1 != end1 && !aborted(); ++i) {
                 applyGate(qc1, it1, result, perm1, LEFT);
                 ++it1;
+                monitor(result);
             }
-            for (unsigned int i = 0; i < ratio2 && it2 != end2; ++i) {
+            for (unsigned int i = 0; i < ratio2 && it2 != end2 && !aborted(); ++i) {
                 applyGate(qc2, it2, result, perm2, RIGHT);
                 ++it2;
+                monitor(result);
+            }
+        }
+    }
+
+    /// Alternate between LEFT and RIGHT applications with a ratio that follows the growth of the DD caused by either side
+    void ImprovedDDEquivalenceChecker::checkSizeFeedback(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2, double maxImbalance) {
+        // weight of the latest size change in the smoothed growth per application and relative adjustment of the ratio per round
+        constexpr double smoothing = 0.5;
+        constexpr double gain      = 0.25;
+
+        // the ratio (applications from LEFT per application from RIGHT) starts like for the proportional strategy
+        const auto base     = static_cast<double>(std::max<std::size_t>(qc1.getNops(), 1U)) / static_cast<double>(std::max<std::size_t>(qc2.getNops(), 1U));
+        maxImbalance        = std::max(maxImbalance, 1.);
+        const auto minRatio = base / maxImbalance;
+        const auto maxRatio = base * maxImbalance;
+        auto       ratio    = base;
+        auto       credit   = 0.;
+
+        auto                  size = static_cast<double>(dd->size(result));
+        std::array<double, 2> growth{};
+        const auto            apply = [&](Direction dir) {
+            auto& it = (dir == LEFT) ? it1 : it2;
+            applyGate((dir == LEFT) ? qc1 : qc2, it, result, (dir == LEFT) ? perm1 : perm2, dir);
+            ++it;
+
+            const auto newSize = static_cast<double>(dd->size(result));
+            auto&      g       = growth[(dir == LEFT) ? 0U : 1U];
+            g                  = smoothing * (newSize - size) + (1. - smoothing) * g;
+            size               = newSize;
+            monitor(result);
+        };
+
+        while (it1 != end1 && it2 != end2 && !aborted()) {
+            credit += ratio;
+            while (credit >= 1. && it1 != end1 && !aborted()) {
+                apply(LEFT);
+                credit -= 1.;
+            }
+            if (it2 != end2 && !aborted()) {
+                apply(RIGHT);
+            }
+
+            // favor the side that recently shrank the DD (or let it grow less)
+            if (growth[0] < growth[1]) {
+                ratio = std::min(ratio * (1. + gain), maxRatio);
+            } else if (growth[0] > growth[1]) {
+                ratio = std::max(ratio / (1. + gain), minRatio);
             }
         }
     }
 
+    /// Pick the gates of both circuits from the frontiers of their commutation DAGs, preferring gates that cancel each other
+    void ImprovedDDEquivalenceChecker::checkCommutation(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2) {
+        CommutationDAG dag1(qc1);
+        CommutationDAG dag2(qc2);
+        const auto     nops1 = static_cast<double>(std::max<std::size_t>(dag1.size(), 1U));
+        const auto     nops2 = static_cast<double>(std::max<std::size_t>(dag2.size(), 1U));
+
+        // step in which either side last applied a gate to a level of the DD (0 if it never did)
+        std::array<std::vector<std::size_t>, 2> touched{std::vector<std::size_t>(nqubits, 0U), std::vector<std::size_t>(nqubits, 0U)};
+        std::size_t                             step = 0U;
+
+        const auto apply = [&](Direction dir, std::size_t index) {
+            auto& qc   = (dir == LEFT) ? qc1 : qc2;
+            auto& perm = (dir == LEFT) ? perm1 : perm2;
+            auto  it   = std::next(qc.begin(), static_cast<std::ptrdiff_t>(index));
+            ++step;
+            for (const auto level: supportLevels(**it, perm)) {
+                touched[(dir == LEFT) ? 0U : 1U][level] = step;
+            }
+            applyGate(qc, it, result, perm, dir);
+            ((dir == LEFT) ? dag1 : dag2).markApplied(index);
+            monitor(result);
+        };
+
+        while ((!dag1.done() || !dag2.done()) && !aborted()) {
+            // apply a pair of gates cancelling each other if both frontiers offer one
+            bool                                found = false;
+            std::pair<std::size_t, std::size_t> pair{};
+            for (const auto i: dag1.frontier()) {
+                for (const auto j: dag2.frontier()) {
+                    if (cancels(**std::next(qc1.begin(), static_cast<std::ptrdiff_t>(i)), perm1, **std::next(qc2.begin(), static_cast<std::ptrdiff_t>(j)), perm2)) {
+                        found = true;
+                        pair  = {i, j};
+                        break;
+                    }
+                }
+                if (found) {
+                    break;
+                }
+            }
+            if (found) {
+                apply(LEFT, pair.first);
+                if (!aborted()) {
+                    apply(RIGHT, pair.second);
+                }
+                continue;
+            }
+
+            // otherwise advance the circuit that lags behind (relative to its gate count) with the gate acting on the levels
+            // most recently touched by the other circuit (the first one in program order on ties)
+            Direction dir = LEFT;
+            if (dag1.done()) {
+                dir = RIGHT;
+            } else if (!dag2.done()) {
+                dir = (static_cast<double>(dag1.appliedOperations()) / nops1 <= static_cast<double>(dag2.appliedOperations()) / nops2) ? LEFT : RIGHT;
+            }
+            const auto& dag   = (dir == LEFT) ? dag1 : dag2;
+            auto&       qc    = (dir == LEFT) ? qc1 : qc2;
+            const auto& perm  = (dir == LEFT) ? perm1 : perm2;
+            const auto& other = touched[(dir == LEFT) ? 1U : 0U];
+
+            auto        best      = dag.frontier().front();
+            std::size_t bestScore = 0U;
+            for (const auto index: dag.frontier()) {
+                std::size_t score = 0U;
+                for (const auto level: supportLevels(**std::next(qc.begin(), static_cast<std::ptrdiff_t>(index)), perm)) {
+                    score += other[level];
+                }
+                if (score > bestScore) {
+                    best      = index;
+                    bestScore = score;
+                }
+            }
+            apply(dir, best);
+        }
+
+        // the applied operations do not form a prefix of the circuits, so both iterators merely account for their number
+        // (all operations unless the check was aborted)
+        it1 = std::next(qc1.begin(), static_cast<std::ptrdiff_t>(dag1.appliedOperations()));
+        it2 = std::next(qc2.begin(), static_cast<std::ptrdiff_t>(dag2.appliedOperations()));
+    }
+
     /// Look-ahead LEFT and RIGHT and choose the more promising option
     void ImprovedDDEquivalenceChecker::checkLookahead(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2) {
         qc::MatrixDD left{}, right{}, saved{};
         bool         cachedLeft = false, cachedRight = false;
 
-        while (it1 != end1 && it2 != end2) {
+        while (it1 != end1 && it2 != end2 && !aborted()) {
             if (!cachedLeft) {
                 // stop if measurement is encountered
                 if ((*it1)->getType() == qc::Measure)
                     break;
 
-                auto nq = (*it1)->getNqubits();
-                (*it1)->setNqubits(nqubits);
-                left = (*it1)->getDD(dd, perm1);
+                left = getGateDD(*it1, perm1, LEFT);
                 dd->incRef(left);
-                (*it1)->setNqubits(nq);
                 ++it1;
                 cachedLeft = true;
             }
@@ -268,11 +462,8 @@ namespace ec {
                 if ((*it2)->getType() == qc::Measure)
                     break;
 
-                auto nq = (*it2)->getNqubits();
-                (*it2)->setNqubits(nqubits);
-                right = (*it2)->getInverseDD(dd, perm2);
+                right = getGateDD(*it2, perm2, RIGHT);
                 dd->incRef(right);
-                (*it2)->setNqubits(nq);
                 ++it2;
                 cachedRight = true;
             }
@@ -295,7 +486,18 @@ namespace ec {
             }
             dd->incRef(result);
             dd->decRef(saved);
-            dd->garbageCollect();
+            afterGate();
+            monitor(result);
+        }
+
+        if (aborted()) {
+            if (cachedLeft) {
+                dd->decRef(left);
+            }
+            if (cachedRight) {
+                dd->decRef(right);
+            }
+            return;
         }
 
         if (cachedLeft) {
@@ -304,7 +506,7 @@ namespace ec {
             dd->incRef(result);
             dd->decRef(saved);
             dd->decRef(left);
-            dd->garbageCollect();
+            afterGate();
         }
 
         if (cachedRight) {
@@ -313,7 +515,119 @@ namespace ec {
             dd->incRef(result);
             dd->decRef(saved);
             dd->decRef(right);
-            dd->garbageCollect();
+            afterGate();
+        }
+    }
+
+    /// Plan several applications ahead with a beam search on predicted DD sizes and only apply the most promising branch
+    void ImprovedDDEquivalenceChecker::checkBeamLookahead(qc::MatrixDD& result, qc::Permutation& perm1, qc::Permutation& perm2, std::size_t depth, std::size_t beamWidth) {
+        using Iterator = decltype(qc1.begin());
+        struct Branch {
+            Iterator                  next1;
+            Iterator                  next2;
+            qc::Permutation           perm1;
+            qc::Permutation           perm2;
+            std::vector<double>       widths;
+            std::vector<std::int64_t> balance;
+            std::vector<Direction>    decisions{};
+            double                    size     = 0.;
+            double                    progress = 0.; // deviation from proportional progress in both circuits (tie breaker)
+        };
+
+        depth     = std::max<std::size_t>(depth, 1U);
+        beamWidth = std::max<std::size_t>(beamWidth, 1U);
+        const auto nops1 = static_cast<double>(std::max<std::size_t>(qc1.getNops(), 1U));
+        const auto nops2 = static_cast<double>(std::max<std::size_t>(qc2.getNops(), 1U));
+
+        // a level holds at most as many nodes as there are paths from the root to it
+        std::vector<double> maxWidths(nqubits);
+        for (std::size_t q = 0U; q < nqubits; ++q) {
+            maxWidths[q] = std::ldexp(1., static_cast<int>(2U * (nqubits - q - 1U)));
+        }
+
+        // Predict the DD after applying the next gate of the branch: the width of every level the gate acts on halves if
+        // the gate brings the level back into balance (i.e., it likely cancels with the other circuit) and doubles otherwise
+        const auto expand = [&](const Branch& branch, Direction dir) {
+            Branch next = branch;
+            auto&  it   = (dir == LEFT) ? next.next1 : next.next2;
+            auto&  perm = (dir == LEFT) ? next.perm1 : next.perm2;
+            const auto& op = **it;
+            if (op.getType() == qc::SWAP && !op.isControlled()) {
+                const auto& targets = op.getTargets();
+                std::swap(perm.at(targets.at(0)), perm.at(targets.at(1)));
+            } else {
+                for (const auto level: supportLevels(op, perm)) {
+                    auto& width = next.widths[level];
+                    next.size -= width;
+                    if (updateBalance(next.balance, level, dir)) {
+                        width = std::max(1., width / 2.);
+                    } else {
+                        width = std::min(2. * width, maxWidths[level]);
+                    }
+                    next.size += width;
+                }
+            }
+            ++it;
+            next.decisions.emplace_back(dir);
+            next.progress = std::abs(static_cast<double>(std::distance(qc1.begin(), next.next1)) / nops1 -
+                                     static_cast<double>(std::distance(qc2.begin(), next.next2)) / nops2);
+            return next;
+        };
+        const auto canExpand = [](const Iterator& it, const decltype(end1)& end) {
+            // stop if measurement is encountered
+            return it != end && (*it)->getType() != qc::Measure;
+        };
+
+        std::vector<std::int64_t> balance(nqubits, 0);
+        while (it1 != end1 && it2 != end2 && !aborted()) {
+            Branch root{it1, it2, perm1, perm2, levelWidths(result, nqubits), balance};
+            for (auto& width: root.widths) {
+                width = std::max(1., width);
+                root.size += width;
+            }
+
+            std::vector<Branch> beam{root};
+            for (std::size_t d = 0U; d < depth; ++d) {
+                std::vector<Branch> candidates{};
+                for (const auto& branch: beam) {
+                    if (canExpand(branch.next1, end1)) {
+                        candidates.emplace_back(expand(branch, LEFT));
+                    }
+                    if (canExpand(branch.next2, end2)) {
+                        candidates.emplace_back(expand(branch, RIGHT));
+                    }
+                }
+                if (candidates.empty()) {
+                    break;
+                }
+                const auto kept = std::min(beamWidth, candidates.size());
+                std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(kept), candidates.end(),
+                                  [](const Branch& a, const Branch& b) {
+                                      return a.size < b.size || (a.size == b.size && a.progress < b.progress);
+                                  });
+                candidates.resize(kept);
+                beam = std::move(candidates);
+            }
+
+            const auto& best = beam.front();
+            if (best.decisions.empty()) {
+                // measurements are handled when finishing both circuits
+                break;
+            }
+
+            // only the chosen branch is actually multiplied
+            for (const auto dir: best.decisions) {
+                auto& it   = (dir == LEFT) ? it1 : it2;
+                auto& perm = (dir == LEFT) ? perm1 : perm2;
+                for (const auto level: supportLevels(**it, perm)) {
+                    updateBalance(balance, level, dir);
+                }
+                applyGate((dir == LEFT) ? qc1 : qc2, it, result, perm, dir);
+                ++it;
+                if (monitor(result)) {
+                    break;
+                }
+            }
         }
     }
 } // namespace ec
@@ -0,0 +1,245 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "MiterCancellation.hpp"
+
+#include "CommutationDAG.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace ec {
+    namespace {
+        using Role = CommutationDAG::Role;
+
+        /// Gate of the miter acting on output qubits (gates of the second circuit are inverted)
+        struct MiterGate {
+            bool                                                   second   = false;
+            std::size_t                                            index    = 0U; // of the operation in its circuit
+            qc::OpType                                             type     = qc::None;
+            dd::fp                                                 angle    = 0.;
+            bool                                                   opaque   = false; // neither cancelled nor merged
+            bool                                                   modified = false;
+            std::vector<std::size_t>                               targets{};
+            std::vector<std::pair<std::size_t, dd::Control::Type>> controls{};
+            std::vector<std::pair<std::size_t, Role>>              roles{};
+        };
+
+        bool isRotation(qc::OpType type) {
+            return type == qc::RX || type == qc::RY || type == qc::RZ || type == qc::Phase;
+        }
+
+        /// Reduce the angle of a rotation to (-period/2, period/2], where rotations by a multiple of the period are the identity
+        /// (including their global phase)
+        dd::fp normalize(dd::fp angle, qc::OpType type) {
+            const auto period = (type == qc::Phase) ? 2. * dd::PI : 4. * dd::PI;
+            auto       a      = std::fmod(angle, period);
+            if (a > period / 2.) {
+                a -= period;
+            } else if (a <= -period / 2.) {
+                a += period;
+            }
+            return a;
+        }
+
+        bool isIdentity(const MiterGate& gate, const dd::fp tolerance) {
+            return gate.type == qc::I || (isRotation(gate.type) && std::abs(normalize(gate.angle, gate.type)) <= tolerance);
+        }
+
+        /// Type of the inverse gate (rotations are inverted by negating their angle) or None if the gate is not supported
+        qc::OpType inverse(qc::OpType type) {
+            switch (type) {
+                case qc::I:
+                case qc::X:
+                case qc::Y:
+                case qc::Z:
+                case qc::H:
+                case qc::RX:
+                case qc::RY:
+                case qc::RZ:
+                case qc::Phase:
+                    return type;
+                case qc::S:
+                    return qc::Sdag;
+                case qc::Sdag:
+                    return qc::S;
+                case qc::T:
+                    return qc::Tdag;
+                case qc::Tdag:
+                    return qc::T;
+                case qc::V:
+                    return qc::Vdag;
+                case qc::Vdag:
+                    return qc::V;
+                case qc::SX:
+                    return qc::SXdag;
+                case qc::SXdag:
+                    return qc::SX;
+                default:
+                    return qc::None;
+            }
+        }
+
+        bool commute(const MiterGate& a, const MiterGate& b) {
+            for (const auto& [qa, ra]: a.roles) {
+                for (const auto& [qb, rb]: b.roles) {
+                    if (qa == qb && (ra == Role::General || ra != rb)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// Resolve the operations of the circuit to gates on the output qubits. Uncontrolled SWAPs only alter the permutation.
+        std::vector<MiterGate> resolve(const qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, bool second, dd::QubitCount nqubits) {
+            auto                   perm = initial;
+            std::vector<MiterGate> gates{};
+            std::size_t            index = 0U;
+            for (const auto& op: qc) {
+                if (op->isStandardOperation() && op->getType() == qc::SWAP && !op->isControlled()) {
+                    const auto& targets = op->getTargets();
+                    std::swap(perm.at(targets.at(0)), perm.at(targets.at(1)));
+                    ++index;
+                    continue;
+                }
+
+                MiterGate gate{};
+                gate.second = second;
+                gate.index  = index++;
+                gate.type   = op->getType();
+                for (const auto& [qubit, role]: CommutationDAG::roles(*op, qc.getNqubits())) {
+                    gate.roles.emplace_back(static_cast<std::size_t>(perm.at(qubit)), role);
+                }
+                gate.opaque = !op->isStandardOperation() || !op->isUnitary() || op->getTargets().size() != 1U || inverse(gate.type) == qc::None;
+                if (!gate.opaque) {
+                    gate.targets.emplace_back(static_cast<std::size_t>(perm.at(op->getTargets().front())));
+                    for (const auto& control: op->getControls()) {
+                        gate.controls.emplace_back(static_cast<std::size_t>(perm.at(control.qubit)), control.type);
+                    }
+                    gate.angle = op->getParameter()[0];
+                    if (second) {
+                        gate.type  = inverse(gate.type);
+                        gate.angle = -gate.angle;
+                    }
+                }
+                gates.emplace_back(std::move(gate));
+            }
+
+            // the level of a qubit at the end of the circuit is moved to its output. Levels without an output are never
+            // identified with the other circuit.
+            std::map<dd::Qubit, dd::Qubit> physical{};
+            for (const auto& [qubit, level]: perm) {
+                physical[level] = qubit;
+            }
+            const auto toOutput = [&](std::size_t level) {
+                if (const auto it = physical.find(static_cast<dd::Qubit>(level)); it != physical.end()) {
+                    if (const auto out = output.find(it->second); out != output.end()) {
+                        return static_cast<std::size_t>(out->second);
+                    }
+                }
+                return (second ? 2U : 1U) * static_cast<std::size_t>(nqubits) + level;
+            };
+            for (auto& gate: gates) {
+                for (auto& target: gate.targets) {
+                    target = toOutput(target);
+                }
+                for (auto& control: gate.controls) {
+                    control.first = toOutput(control.first);
+                }
+                std::sort(gate.controls.begin(), gate.controls.end());
+                for (auto& role: gate.roles) {
+                    role.first = toOutput(role.first);
+                }
+            }
+            return gates;
+        }
+    } // namespace
+
+    MiterCancellationStatistics cancelMiterGates(qc::QuantumComputation& qc1, const qc::Permutation& initial1, const qc::Permutation& output1,
+                                                 qc::QuantumComputation& qc2, const qc::Permutation& initial2, const qc::Permutation& output2,
+                                                 const std::vector<bool>& garbage, dd::QubitCount nqubits, const dd::fp tolerance) {
+        // G followed by the inverse of G'
+        auto miter  = resolve(qc1, initial1, output1, false, nqubits);
+        auto gates2 = resolve(qc2, initial2, output2, true, nqubits);
+        miter.insert(miter.end(), std::make_move_iterator(gates2.rbegin()), std::make_move_iterator(gates2.rend()));
+
+        // gates of G and G' may only cancel if they do not act on garbage outputs
+        const auto crossable = [&](const MiterGate& gate) {
+            return std::all_of(gate.roles.begin(), gate.roles.end(), [&](const auto& role) {
+                return role.first < nqubits && (role.first >= garbage.size() || !garbage[role.first]);
+            });
+        };
+
+        MiterCancellationStatistics stats{};
+        std::vector<bool>           removed(miter.size(), false);
+        std::vector<std::size_t>    live{};
+        for (std::size_t i = 0U; i < miter.size(); ++i) {
+            const auto& gate = miter[i];
+            if (!gate.opaque && isIdentity(gate, tolerance)) {
+                removed[i] = true;
+                continue;
+            }
+
+            // move the gate towards the preceding gates as long as it commutes with them
+            for (auto j = live.size(); j-- > 0U && !gate.opaque;) {
+                auto& other = miter[live[j]];
+                if (!other.opaque && other.targets == gate.targets && other.controls == gate.controls && (other.second == gate.second || crossable(gate))) {
+                    if (isRotation(gate.type) && other.type == gate.type) {
+                        other.angle += gate.angle;
+                        other.modified = true;
+                        removed[i]     = true;
+                        ++stats.mergedRotations;
+                        if (isIdentity(other, tolerance)) {
+                            removed[live[j]] = true;
+                            live.erase(live.begin() + static_cast<std::ptrdiff_t>(j));
+                        }
+                        break;
+                    }
+                    if (!isRotation(gate.type) && other.type == inverse(gate.type)) {
+                        removed[i]       = true;
+                        removed[live[j]] = true;
+                        live.erase(live.begin() + static_cast<std::ptrdiff_t>(j));
+                        break;
+                    }
+                }
+                if (!commute(other, gate)) {
+                    break;
+                }
+            }
+            if (!removed[i]) {
+                live.emplace_back(i);
+            }
+        }
+
+        // write the miter back to both circuits
+        std::vector<std::size_t> erase1{};
+        std::vector<std::size_t> erase2{};
+        for (std::size_t i = 0U; i < miter.size(); ++i) {
+            const auto& gate = miter[i];
+            auto&       qc   = gate.second ? qc2 : qc1;
+            if (removed[i]) {
+                (gate.second ? erase2 : erase1).emplace_back(gate.index);
+                continue;
+            }
+            if (gate.modified) {
+                auto&      op    = *std::next(qc.begin(), static_cast<std::ptrdiff_t>(gate.index));
+                const auto angle = normalize(gate.second ? -gate.angle : gate.angle, gate.type);
+                op               = std::make_unique<qc::StandardOperation>(op->getNqubits(), op->getControls(), op->getTargets().front(), op->getType(), angle);
+            }
+        }
+        for (auto* erase: {&erase1, &erase2}) {
+            auto& qc = (erase == &erase1) ? qc1 : qc2;
+            std::sort(erase->begin(), erase->end(), std::greater<>());
+            for (const auto index: *erase) {
+                qc.erase(std::next(qc.cbegin(), static_cast<std::ptrdiff_t>(index)));
+            }
+        }
+        stats.removedGates1 = erase1.size();
+        stats.removedGates2 = erase2.size();
+        return stats;
+    }
+} // namespace ec
@@ -5,88 +5,572 @@
 
 #include "SimulationBasedEquivalenceChecker.hpp"
 
+#include "CrossPackage.hpp"
+
 namespace ec {
+    namespace {
+        struct GateInfo {
+            std::string            signature;
+            std::vector<dd::Qubit> qubits;
+        };
 
-    bool SimulationBasedEquivalenceChecker::simulateWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
-        auto map = initial1;
+        dd::Qubit logical(dd::Qubit physical, const qc::Permutation& layout) {
+            auto it = layout.find(physical);
+            return it != layout.end() ? it->second : physical;
+        }
+
+        /// Structural signature of an operation on logical qubits
+        void appendSignature(std::ostringstream& ss, qc::Operation& op, const qc::Permutation& layout) {
+            if (op.isCompoundOperation()) {
+                ss << "{";
+                for (auto& sub: dynamic_cast<qc::CompoundOperation&>(op)) {
+                    appendSignature(ss, *sub, layout);
+                }
+                ss << "}";
+                return;
+            }
+            ss << static_cast<int>(op.getType()) << "(";
+            for (const auto& control: op.getControls()) {
+                ss << (control.type == dd::Control::Type::pos ? "c" : "n") << static_cast<int>(logical(control.qubit, layout)) << ",";
+            }
+            for (const auto& target: op.getTargets()) {
+                ss << static_cast<int>(logical(target, layout)) << ",";
+            }
+            for (const auto parameter: op.getParameter()) {
+                ss << std::llround(parameter * 1e10) << ",";
+            }
+            ss << ")";
+        }
+
+        std::vector<GateInfo> analyseGates(qc::QuantumComputation& qc, const qc::Permutation& layout, dd::QubitCount nqubits) {
+            std::vector<GateInfo> gates{};
+            gates.reserve(qc.getNops());
+            for (auto& op: qc) {
+                if (!op->isUnitary()) {
+                    continue;
+                }
+                GateInfo           info{};
+                std::ostringstream ss{};
+                appendSignature(ss, *op, layout);
+                info.signature = ss.str();
+                for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+                    if (op->actsOn(q)) {
+                        info.qubits.push_back(logical(q, layout));
+                    }
+                }
+                gates.emplace_back(std::move(info));
+            }
+            return gates;
+        }
+    } // namespace
+
+
+    qc::VectorDD SimulationBasedEquivalenceChecker::simulate(const qc::VectorDD& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, Approximation* approximation) {
+        auto map = initial;
         auto e   = stimulus;
         dd->incRef(e);
-        it1 = qc1.begin();
 
-        while (it1 != end1) {
-            applyGate(qc1, it1, e, map);
-            ++it1;
+        auto it = qc.begin();
+        for (; it != qc.end() && !resourceLimits.hit; ++it) {
+            applyGate(qc, it, e, map);
+            if (approximation != nullptr) {
+                approximateState(e, *approximation, dd);
+            }
+        }
+        if (resourceLimits.hit) {
+            recordLimitGates(qc, it);
+            return e;
         }
         // correct permutation if necessary
-        qc::QuantumComputation::changePermutation(e, map, output1, dd);
-        e = dd->reduceGarbage(e, garbage1);
+        qc::QuantumComputation::changePermutation(e, map, output, dd);
+        e = dd->reduceGarbage(e, garbage);
+        return e;
+    }
 
-        map    = initial2;
-        auto f = stimulus;
-        dd->incRef(f);
-        it2 = qc2.begin();
+    std::vector<std::unique_ptr<qc::Operation>> SimulationBasedEquivalenceChecker::cloneOperations(qc::QuantumComputation& qc) const {
+        std::vector<std::unique_ptr<qc::Operation>> ops{};
+        ops.reserve(qc.getNops());
+        for (auto it = qc.begin(); it != qc.end(); ++it) {
+            // Measurements at the end of the circuit are considered NOPs.
+            if ((*it)->getType() == qc::Measure) {
+                if (!qc.isLastOperationOnQubit(it, qc.cend())) {
+                    throw std::invalid_argument("Intermediate measurements currently not supported. Defer your measurements to the end.");
+                }
+                continue;
+            }
+            ops.emplace_back((*it)->clone());
+            ops.back()->setNqubits(nqubits);
+        }
+        return ops;
+    }
 
-        while (it2 != end2) {
-            applyGate(qc2, it2, f, map);
-            ++it2;
+    qc::VectorDD SimulationBasedEquivalenceChecker::simulate(const qc::VectorDD& stimulus, const std::vector<std::unique_ptr<qc::Operation>>& ops, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, std::unique_ptr<dd::Package>& package, GarbageCollector& collector, ResourceLimits& limits, const std::atomic<bool>& cancelled, Approximation* approximation, bool* completed) {
+        auto map = initial;
+        auto e   = stimulus;
+        package->incRef(e);
+        if (completed != nullptr) {
+            *completed = false;
         }
 
+        for (const auto& op: ops) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return e;
+            }
+            auto saved = e;
+            e          = package->multiply(op->getDD(package, map), e);
+            package->incRef(e);
+            package->decRef(saved);
+            collector.collect(*package);
+            if (limits.enabled() && limits.exceeded(*package)) {
+                return e;
+            }
+            if (approximation != nullptr) {
+                approximateState(e, *approximation, package);
+            }
+        }
         // correct permutation if necessary
-        qc::QuantumComputation::changePermutation(f, map, output2, dd);
-        f = dd->reduceGarbage(f, garbage2);
+        qc::QuantumComputation::changePermutation(e, map, output, package);
+        e = package->reduceGarbage(e, garbage);
+        if (completed != nullptr) {
+            *completed = true;
+        }
+        return e;
+    }
 
-        results.fidelity = dd->fidelity(e, f);
+    void SimulationBasedEquivalenceChecker::setupSimulationCache(const Configuration& config) {
+        if (config.simulationCacheDirectory.empty()) {
+            simulationCache.reset();
+            return;
+        }
+        simulationCache = std::make_unique<SimulationCache>(config.simulationCacheDirectory, config.simulationCacheSize);
+        cacheTolerance  = config.tolerance;
 
-        results.nsims++;
+        // the output only depends on the operations (after all passes) and how the qubits are permuted and reduced
+        std::ostringstream ss{};
+        ss << static_cast<int>(nqubits) << ";";
+        for (auto& op: qc1) {
+            appendSignature(ss, *op, {});
+        }
+        ss << ";";
+        for (const auto& [physical, logical]: initial1) {
+            ss << static_cast<int>(physical) << ">" << static_cast<int>(logical) << ",";
+        }
+        ss << ";";
+        for (const auto& [physical, logical]: output1) {
+            ss << static_cast<int>(physical) << ">" << static_cast<int>(logical) << ",";
+        }
+        ss << ";";
+        for (const auto g: garbage1) {
+            ss << g;
+        }
+        circuitHash1 = SimulationCache::hash(ss.str());
+    }
+
+    void SimulationBasedEquivalenceChecker::storeSimulationCacheStatistics(EquivalenceCheckingResults& results) const {
+        if (simulationCache) {
+            results.simulationCacheHits += simulationCache->hits();
+            results.simulationCacheMisses += simulationCache->misses();
+        }
+    }
 
-        if (results.fidelity < config.fidelity_limit) {
+    void SimulationBasedEquivalenceChecker::approximateState(qc::VectorDD& e, Approximation& approximation, std::unique_ptr<dd::Package>& package) {
+        if (approximation.nodeBudget == 0U) {
+            return;
+        }
+        const std::size_t nodes = package->size(e);
+        approximation.peakNodes = std::max(approximation.peakNodes, nodes);
+        if (nodes > approximation.nodeBudget) {
+            // pruning to half of the budget leaves room for the next gates before another round of pruning is necessary
+            dd::fp     fidelity     = 1.;
+            const auto approximated = approximate(e, approximation.nodeBudget / 2U, package, fidelity);
+            package->incRef(approximated);
+            package->decRef(e);
+            e = approximated;
+            // the gates preserve the angle to the exact state, so the angles of all rounds add up (triangle inequality)
+            approximation.angle += std::acos(std::sqrt(std::clamp(fidelity, 0., 1.)));
+            ++approximation.rounds;
+        }
+    }
+
+    void SimulationBasedEquivalenceChecker::storeApproximation(EquivalenceCheckingResults& results, const Approximation& approximation1, const Approximation& approximation2) const {
+        results.fidelityLowerBound = results.fidelity;
+        results.fidelityUpperBound = results.fidelity;
+        if (approximation1.nodeBudget == 0U && approximation2.nodeBudget == 0U) {
+            return;
+        }
+        const auto angle = approximation1.angle + approximation2.angle;
+        const auto hasGarbage = std::any_of(garbage1.begin(), garbage1.end(), [](bool g) { return g; }) ||
+                                std::any_of(garbage2.begin(), garbage2.end(), [](bool g) { return g; });
+        if (angle > 0. && hasGarbage) {
+            // the angle to the exact state is not preserved by reducing the garbage outputs
+            results.fidelityLowerBound = 0.;
+            results.fidelityUpperBound = 1.;
+        } else if (angle > 0.) {
+            results.fidelityLowerBound = fidelityLowerBound(results.fidelity, angle);
+            results.fidelityUpperBound = fidelityUpperBound(results.fidelity, angle);
+        }
+        results.approximated = true;
+        results.approximations += approximation1.rounds + approximation2.rounds;
+        results.approximationPeakNodes = std::max({results.approximationPeakNodes, approximation1.peakNodes, approximation2.peakNodes});
+    }
+
+    qc::VectorDD SimulationBasedEquivalenceChecker::simulateFirstCircuit(const qc::VectorDD& stimulus, Approximation* approximation) {
+        if (approximation != nullptr && approximation->nodeBudget > 0U) {
+            return simulate(stimulus, qc1, initial1, output1, garbage1, approximation);
+        }
+        if (!simulationCache) {
+            return simulate(stimulus, qc1, initial1, output1, garbage1);
+        }
+        qc::VectorDD e{};
+        if (simulationCache->load(circuitHash1, cacheTolerance, stimulus, dd, e)) {
+            dd->incRef(e);
+            return e;
+        }
+        e = simulate(stimulus, qc1, initial1, output1, garbage1);
+        if (!resourceLimits.hit) {
+            simulationCache->store(circuitHash1, cacheTolerance, stimulus, e);
+        }
+        return e;
+    }
+
+    void SimulationBasedEquivalenceChecker::setupConcurrentSimulation(const Configuration& config) {
+        if (!config.concurrentCircuitSimulation) {
+            ops2.clear();
+            return;
+        }
+        if (!dd2) {
+            dd2 = std::make_unique<dd::Package>(nqubits);
+        }
+        // the second circuit is simulated from copies of its operations so that no operation is shared between threads
+        ops2 = cloneOperations(qc2);
+    }
+
+    void SimulationBasedEquivalenceChecker::setupDenseSimulation(const Configuration& config) {
+        // the passes might have replaced operations, so the matrices of an earlier check are not reused
+        denseMatrices.clear();
+        if (config.simulationBackend == SimulationBackend::DecisionDiagram) {
+            return;
+        }
+        for (const auto& op: qc1) {
+            DenseState::addGateMatrices(*op, denseMatrices);
+        }
+        for (const auto& op: qc2) {
+            DenseState::addGateMatrices(*op, denseMatrices);
+        }
+    }
+
+    bool SimulationBasedEquivalenceChecker::concludeSimulation(EquivalenceCheckingResults& results, const Configuration& config) const {
+        if (resourceLimits.hit) {
+            // the interrupted simulation does not count
+            --results.nsims;
+            results.equivalence = ec::Equivalence::NoInformation;
+            return true;
+        }
+        if (results.fidelityUpperBound < config.fidelity_limit) {
             results.equivalence = ec::Equivalence::NotEquivalent;
-            dd->decRef(e);
-            dd->decRef(f);
+            return true;
+        }
+        if (results.fidelityLowerBound < config.fidelity_limit) {
+            // the approximation is too coarse to decide whether the outputs differ
+            results.equivalence = ec::Equivalence::NoInformation;
+            return true;
+        }
+        if (!guidedStimuli && results.nsims == numberOfClassicalStimuli()) {
+            results.equivalence = ec::Equivalence::Equivalent;
+            return true;
+        }
+        results.equivalence = ec::Equivalence::ProbablyEquivalent;
+        return false;
+    }
+
+    void SimulationBasedEquivalenceChecker::applyGate(qc::QuantumComputation& qc, decltype(qc1.begin())& opIt, DenseState& state, qc::Permutation& permutation) {
+        // Measurements at the end of the circuit are considered NOPs.
+        if ((*opIt)->getType() == qc::Measure) {
+            if (!qc.isLastOperationOnQubit(opIt, qc.cend())) {
+                throw std::invalid_argument("Intermediate measurements currently not supported. Defer your measurements to the end.");
+            }
+            return;
+        }
+        state.apply(**opIt, permutation, &denseMatrices);
+        if (resourceLimits.enabled()) {
+            resourceLimits.exceeded(*dd);
+        }
+    }
+
+    void SimulationBasedEquivalenceChecker::recordLimitGates(const qc::QuantumComputation& qc, decltype(qc1.cbegin()) it) {
+        const auto gates = static_cast<std::size_t>(std::distance(qc.cbegin(), it));
+        if (gates == 0U) {
+            // the limit has already been exceeded while simulating another circuit
+            return;
+        }
+        if (&qc == &qc1) {
+            limitGates1 = gates;
+            limitGates2 = 0U;
+        } else {
+            // the first circuit has been simulated completely
+            limitGates1 = qc1.getNops();
+            limitGates2 = gates;
+        }
+    }
 
+    DenseState SimulationBasedEquivalenceChecker::simulate(const DenseState& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage) {
+        auto map   = initial;
+        auto state = stimulus;
+        auto it    = qc.begin();
+        for (; it != qc.end() && !resourceLimits.hit; ++it) {
+            applyGate(qc, it, state, map);
+        }
+        if (resourceLimits.hit) {
+            recordLimitGates(qc, it);
+            return state;
+        }
+        // correct permutation if necessary
+        state.changePermutation(map, output);
+        state.reduceGarbage(garbage);
+        return state;
+    }
+
+    void SimulationBasedEquivalenceChecker::simulateDenselyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        const auto in = DenseState::fromVectorDD(stimulus, nqubits);
+        const auto e  = simulate(in, qc1, initial1, output1, garbage1);
+        const auto f  = simulate(in, qc2, initial2, output2, garbage2);
+
+        results.fidelity           = e.fidelity(f);
+        results.fidelityLowerBound = results.fidelity;
+        results.fidelityUpperBound = results.fidelity;
+
+        if (outputsDiffer(results, config)) {
             if (config.storeCEXinput) {
                 results.cexInput = dd->getVector(stimulus);
             }
             if (config.storeCEXoutput) {
-                results.circuit1.cexOutput = dd->getVector(e);
-                results.circuit2.cexOutput = dd->getVector(f);
+                results.circuit1.cexOutput = e.getVector();
+                results.circuit2.cexOutput = f.getVector();
+            }
+        }
+    }
+
+    qc::VectorDD SimulationBasedEquivalenceChecker::simulateAdaptively(const qc::VectorDD& stimulus, qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& garbage, std::optional<DenseState>& dense, EquivalenceCheckingResults& results, const Configuration& config) {
+        const bool   switchable  = nqubits <= DenseState::MAX_QUBITS;
+        const double denseMemory = switchable ? 2. * sizeof(dd::fp) * static_cast<double>(std::size_t{1} << nqubits) : 0.;
+
+        auto map = initial;
+        auto e   = stimulus;
+        dd->incRef(e);
+
+        std::size_t gate = 0U;
+        auto        it   = qc.begin();
+        for (; it != qc.end() && !resourceLimits.hit; ++it, ++gate) {
+            if (dense) {
+                applyGate(qc, it, *dense, map);
+                continue;
             }
+            applyGate(qc, it, e, map);
 
-            dd->garbageCollect();
-            return true;
-        } else if (results.nsims == static_cast<std::size_t>(std::pow(2.L, nqubits_for_stimuli))) {
-            results.equivalence = ec::Equivalence::Equivalent;
-            dd->decRef(e);
-            dd->decRef(f);
-            dd->garbageCollect();
-            return true;
+            const auto memory       = dd->vUniqueTable.getActiveNodeCount() * sizeof(dd::Package::vNode);
+            results.peakStateMemory = std::max(results.peakStateMemory, memory);
+            if (switchable && static_cast<double>(memory) > config.denseSwitchThreshold * denseMemory) {
+                const auto start = std::chrono::steady_clock::now();
+                dense.emplace(DenseState::fromVectorDD(e, nqubits));
+                dd->decRef(e);
+                dd->garbageCollect();
+                e = qc::VectorDD::zero;
+                const std::chrono::duration<double> conversionTime = std::chrono::steady_clock::now() - start;
+
+                if (results.denseSwitches == 0U) {
+                    results.denseSwitchGate = gate;
+                }
+                ++results.denseSwitches;
+                results.denseConversionTime += conversionTime.count();
+                results.peakStateMemory = std::max(results.peakStateMemory, dense->memory());
+            }
+        }
+
+        if (resourceLimits.hit) {
+            recordLimitGates(qc, it);
+            return e;
+        }
+
+        // correct permutation if necessary
+        if (dense) {
+            dense->changePermutation(map, output);
+            dense->reduceGarbage(garbage);
+            return e;
+        }
+        qc::QuantumComputation::changePermutation(e, map, output, dd);
+        e = dd->reduceGarbage(e, garbage);
+        return e;
+    }
+
+    void SimulationBasedEquivalenceChecker::simulateAdaptivelyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        std::optional<DenseState> dense1{};
+        std::optional<DenseState> dense2{};
+        auto                      e = simulateAdaptively(stimulus, qc1, initial1, output1, garbage1, dense1, results, config);
+        auto                      f = simulateAdaptively(stimulus, qc2, initial2, output2, garbage2, dense2, results, config);
+
+        if (!dense1 && !dense2) {
+            results.fidelity = dd->fidelity(e, f);
         } else {
-            results.equivalence = ec::Equivalence::ProbablyEquivalent;
-            dd->decRef(e);
-            dd->decRef(f);
-            dd->garbageCollect();
-            return false;
+            // compare in dense form once any of both circuits switched
+            const auto start = std::chrono::steady_clock::now();
+            if (!dense1) {
+                dense1.emplace(DenseState::fromVectorDD(e, nqubits));
+            }
+            if (!dense2) {
+                dense2.emplace(DenseState::fromVectorDD(f, nqubits));
+            }
+            const std::chrono::duration<double> conversionTime = std::chrono::steady_clock::now() - start;
+            results.denseConversionTime += conversionTime.count();
+            results.fidelity = dense1->fidelity(*dense2);
+        }
+        results.fidelityLowerBound = results.fidelity;
+        results.fidelityUpperBound = results.fidelity;
+
+        if (outputsDiffer(results, config)) {
+            if (config.storeCEXinput) {
+                results.cexInput = dd->getVector(stimulus);
+            }
+            if (config.storeCEXoutput) {
+                results.circuit1.cexOutput = dense1 ? dense1->getVector() : dd->getVector(e);
+                results.circuit2.cexOutput = dense2 ? dense2->getVector() : dd->getVector(f);
+            }
         }
+        dd->decRef(e);
+        dd->decRef(f);
+        dd->garbageCollect();
     }
 
-    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomClassicalStimulus() {
-        // generate distinct stimulus
-        auto [new_stimulus, success] = stimuli.insert(stimuliGenerator());
-        while (!success) {
-            std::tie(new_stimulus, success) = stimuli.insert(stimuliGenerator());
+    bool SimulationBasedEquivalenceChecker::outputsDiffer(const EquivalenceCheckingResults& results, const Configuration& config) const {
+        return !resourceLimits.hit && results.fidelityUpperBound < config.fidelity_limit;
+    }
+
+    void SimulationBasedEquivalenceChecker::checkBackend(const Configuration& config) {
+        if (config.simulationBackend != SimulationBackend::DecisionDiagram && config.approximationNodeBudget > 0U) {
+            throw std::invalid_argument("Approximate simulation is only supported by the DD simulation backend.");
         }
-        std::vector<bool> stimulusBits(nqubits_for_stimuli);
-        for (int i = 0; i < nqubits_for_stimuli; ++i) {
-            if (*new_stimulus & (1 << i)) {
-                stimulusBits[i] = true;
+    }
+
+    void SimulationBasedEquivalenceChecker::compareWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        if (config.simulationBackend == SimulationBackend::Dense) {
+            simulateDenselyWithStimulus(stimulus, results, config);
+            return;
+        }
+        if (config.simulationBackend == SimulationBackend::Adaptive) {
+            simulateAdaptivelyWithStimulus(stimulus, results, config);
+            return;
+        }
+        if (config.concurrentCircuitSimulation) {
+            simulateConcurrentlyWithStimulus(stimulus, results, config);
+            return;
+        }
+
+        Approximation approximation1{config.approximationNodeBudget};
+        Approximation approximation2{config.approximationNodeBudget};
+        auto          e = simulateFirstCircuit(stimulus, &approximation1);
+        auto          f = simulate(stimulus, qc2, initial2, output2, garbage2, &approximation2);
+
+        results.fidelity = dd->fidelity(e, f);
+        storeApproximation(results, approximation1, approximation2);
+
+        if (outputsDiffer(results, config)) {
+            if (config.storeCEXinput) {
+                results.cexInput = dd->getVector(stimulus);
+            }
+            if (config.storeCEXoutput) {
+                results.circuit1.cexOutput = dd->getVector(e);
+                results.circuit2.cexOutput = dd->getVector(f);
+            }
+        }
+        dd->decRef(e);
+        dd->decRef(f);
+        dd->garbageCollect();
+    }
+
+    bool SimulationBasedEquivalenceChecker::simulateWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        compareWithStimulus(stimulus, results, config);
+        results.nsims++;
+        return concludeSimulation(results, config);
+    }
+
+    void SimulationBasedEquivalenceChecker::simulateConcurrentlyWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        auto stimulus2 = transfer(stimulus, dd2);
+        dd2->incRef(stimulus2);
+
+        // simulate the second circuit in its own package on a separate thread while this thread simulates the first one
+        qc::VectorDD       f{};
+        std::atomic<bool>  cancelled{false};
+        std::exception_ptr error{};
+        Approximation      approximation1{config.approximationNodeBudget};
+        Approximation      approximation2{config.approximationNodeBudget};
+        GarbageCollector   collector2{config};
+        ResourceLimits     limits2{config};
+        std::thread        second([&]() {
+            try {
+                f = simulate(stimulus2, ops2, initial2, output2, garbage2, dd2, collector2, limits2, cancelled, &approximation2);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+
+        qc::VectorDD e{};
+        try {
+            e = simulateFirstCircuit(stimulus, &approximation1);
+        } catch (...) {
+            cancelled.store(true);
+            second.join();
+            throw;
+        }
+        second.join();
+        garbageCollector.merge(collector2);
+        resourceLimits.merge(limits2);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        results.fidelity = ec::fidelity(e, f);
+        storeApproximation(results, approximation1, approximation2);
+
+        if (outputsDiffer(results, config)) {
+            if (config.storeCEXinput) {
+                results.cexInput = dd->getVector(stimulus);
+            }
+            if (config.storeCEXoutput) {
+                results.circuit1.cexOutput = dd->getVector(e);
+                results.circuit2.cexOutput = dd2->getVector(f);
             }
         }
-        auto in = dd->makeBasisState(nqubits, stimulusBits);
+
+        dd->decRef(e);
+        dd2->decRef(f);
+        dd2->decRef(stimulus2);
+        dd->garbageCollect();
+        dd2->garbageCollect();
+        results.maxActive = std::max(results.maxActive, dd2->vUniqueTable.getMaxActiveNodes());
+    }
+
+    void SimulationBasedEquivalenceChecker::resetStimuli(const Configuration& config) {
+        std::lock_guard lock(generatorMutex);
+        classicalStimuli      = StimulusPermutation(nqubits_for_stimuli, mt());
+        nextClassicalStimulus = 0U;
+        globalStimuliDepth    = config.globalStimuliDepth > 0U ? config.globalStimuliDepth : defaultGlobalStimuliDepth();
+    }
+
+    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomClassicalStimulus(std::unique_ptr<dd::Package>& package) {
+        std::uint64_t index = 0U;
+        {
+            std::lock_guard lock(generatorMutex);
+            // all 2^n stimuli have been used once the index wraps around
+            index = nextClassicalStimulus++ % classicalStimuli.size();
+        }
+        auto stimulusBits = classicalStimuli(index);
+        stimulusBits.resize(nqubits);
+        auto in = package->makeBasisState(nqubits, stimulusBits);
         return in;
     }
 
-    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomLocalQuantumStimulus() {
-        auto stimulus = std::vector<dd::BasisStates>(nqubits, dd::BasisStates::zero);
+    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomLocalQuantumStimulus(std::unique_ptr<dd::Package>& package) {
+        auto            stimulus = std::vector<dd::BasisStates>(nqubits, dd::BasisStates::zero);
+        std::lock_guard lock(generatorMutex);
         for (int i = 0; i < nqubits_for_stimuli; ++i) {
             switch (basisStateGenerator()) {
                 case 0:
@@ -111,45 +595,147 @@ namespace ec {
                     stimulus.at(i) = dd::BasisStates::zero;
             }
         }
-        auto in = dd->makeBasisState(nqubits, stimulus);
+        auto in = package->makeBasisState(nqubits, stimulus);
         return in;
     }
 
-    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomGlobalQuantumStimulus() {
-        auto rcs        = qc::RandomCliffordCircuit(nqubits_for_stimuli, static_cast<unsigned int>(std::round(std::log2(nqubits_for_stimuli))), stimuliGenerator());
-        auto stabilizer = rcs.simulate(dd->makeZeroState(nqubits_for_stimuli), dd);
-        dd->decRef(stabilizer); // decrease right after so the reference count stays correct later on
+    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomGlobalQuantumStimulus(std::unique_ptr<dd::Package>& package) {
+        // the random stabilizer state is sampled on a tableau and converted to a DD in a single pass (instead of simulating
+        // a random Clifford circuit gate by gate). The qubits beyond the stimuli qubits remain in the |0> state.
+        auto tableau = StabilizerTableau::zeroState(nqubits);
+        {
+            std::lock_guard lock(generatorMutex);
+            tableau.randomize(nqubits_for_stimuli, globalStimuliDepth, mt);
+        }
+        return tableau.toVectorDD(package);
+    }
+
+    void SimulationBasedEquivalenceChecker::setupGuidedStimuli(const Configuration& config, EquivalenceCheckingResults& results) {
+        guidedStimuli = false;
+        guidedQubits.assign(nqubits, false);
+        if (!config.differenceGuidedStimuli || config.stimuliType == StimuliType::GlobalQuantum) {
+            return;
+        }
+
+        // gates of both circuits are matched by their signature. Whatever remains unmatched constitutes the difference.
+        const auto gates1 = analyseGates(qc1, initial1, nqubits);
+        const auto gates2 = analyseGates(qc2, initial2, nqubits);
+
+        std::unordered_map<std::string, long long> balance{};
+        for (const auto& gate: gates1) {
+            ++balance[gate.signature];
+        }
+        for (const auto& gate: gates2) {
+            --balance[gate.signature];
+        }
+        std::size_t unmatched = 0U;
+        for (const auto& [signature, count]: balance) {
+            unmatched += static_cast<std::size_t>(std::abs(count));
+        }
+        // nothing to guide by if the circuits are structurally identical or hardly related (e.g., compiled circuits)
+        if (unmatched == 0U || 2U * unmatched > gates1.size() + gates2.size()) {
+            return;
+        }
+
+        // backward light cone of all unmatched gates, i.e., all inputs that influence any of them
+        const auto addLightCone = [&](const std::vector<GateInfo>& gates, long long sign) {
+            std::vector<bool> cone(nqubits);
+            for (auto it = gates.rbegin(); it != gates.rend(); ++it) {
+                bool relevant = sign * balance.at(it->signature) > 0;
+                for (const auto q: it->qubits) {
+                    relevant = relevant || (static_cast<std::size_t>(q) < cone.size() && cone[q]);
+                }
+                if (relevant) {
+                    for (const auto q: it->qubits) {
+                        if (static_cast<std::size_t>(q) < cone.size()) {
+                            cone[q] = true;
+                        }
+                    }
+                }
+            }
+            for (std::size_t q = 0U; q < cone.size(); ++q) {
+                guidedQubits[q] = guidedQubits[q] || cone[q];
+            }
+        };
+        addLightCone(gates1, 1);
+        addLightCone(gates2, -1);
 
-        std::array<qc::VectorDD, 2> edges{};
-        edges[1] = qc::VectorDD::zero;
+        guidedStimuli        = true;
+        results.guidedQubits = static_cast<std::size_t>(std::count(guidedQubits.begin(), guidedQubits.end(), true));
+    }
 
-        auto initial = stabilizer;
-        for (std::size_t p = 0; p < static_cast<std::size_t>(nqubits - nqubits_for_stimuli); p++) {
-            edges[0] = initial;
-            initial  = dd->makeDDNode(static_cast<dd::Qubit>(p + nqubits_for_stimuli), edges);
+    qc::VectorDD SimulationBasedEquivalenceChecker::generateGuidedStimulus(StimuliType type, std::unique_ptr<dd::Package>& package) {
+        auto            stimulus = std::vector<dd::BasisStates>(nqubits, dd::BasisStates::zero);
+        std::lock_guard lock(generatorMutex);
+        for (int i = 0; i < nqubits_for_stimuli; ++i) {
+            if (guidedQubits.at(i)) {
+                // excite the qubits affecting the differences between both circuits
+                switch (basisStateGenerator()) {
+                    case 0:
+                    case 1:
+                        stimulus.at(i) = dd::BasisStates::one;
+                        break;
+                    case 2:
+                        stimulus.at(i) = dd::BasisStates::plus;
+                        break;
+                    case 3:
+                        stimulus.at(i) = dd::BasisStates::minus;
+                        break;
+                    case 4:
+                        stimulus.at(i) = dd::BasisStates::right;
+                        break;
+                    default:
+                        stimulus.at(i) = dd::BasisStates::left;
+                }
+            } else if (type == StimuliType::Classical) {
+                stimulus.at(i) = (mt() & 1U) ? dd::BasisStates::one : dd::BasisStates::zero;
+            } else {
+                stimulus.at(i) = static_cast<dd::BasisStates>(basisStateGenerator());
+            }
         }
-        return initial;
+        auto in = package->makeBasisState(nqubits, stimulus);
+        return in;
     }
 
-    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomStimulus(StimuliType type) {
+    qc::VectorDD SimulationBasedEquivalenceChecker::generateRandomStimulus(StimuliType type, std::unique_ptr<dd::Package>& package) {
+        if (guidedStimuli && type != StimuliType::GlobalQuantum) {
+            return generateGuidedStimulus(type, package);
+        }
         switch (type) {
             case ec::StimuliType::Classical:
-                return generateRandomClassicalStimulus();
+                return generateRandomClassicalStimulus(package);
             case ec::StimuliType::LocalQuantum:
-                return generateRandomLocalQuantumStimulus();
+                return generateRandomLocalQuantumStimulus(package);
             case ec::StimuliType::GlobalQuantum:
-                return generateRandomGlobalQuantumStimulus();
+                return generateRandomGlobalQuantumStimulus(package);
         }
         return qc::VectorDD::zero;
     }
 
     EquivalenceCheckingResults SimulationBasedEquivalenceChecker::check(const Configuration& config) {
+        checkBackend(config);
+        if (config.estimateFidelity) {
+            return estimateFidelity(config);
+        }
+        if (config.adaptiveStimuli) {
+            return checkAdaptive(config);
+        }
+        if (config.nthreads > 1) {
+            return checkParallel(config);
+        }
+
+        ToleranceGuard             guard(config.tolerance);
         EquivalenceCheckingResults results{};
         setupResults(results);
         results.stimuliType = config.stimuliType;
+        resetStimuli(config);
 
         auto start = std::chrono::steady_clock::now();
         runPreCheckPasses(config);
+        setupConcurrentSimulation(config);
+        setupDenseSimulation(config);
+        setupSimulationCache(config);
+        setupGuidedStimuli(config, results);
         auto endPreprocessing = std::chrono::steady_clock::now();
 
         bool done = false;
@@ -166,13 +752,494 @@ namespace ec {
         results.preprocessingTime                       = preprocessingTime.count();
         results.verificationTime                        = verificationTime.count();
         results.maxActive                               = std::max(results.maxActive, dd->vUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
+        storeSimulationCacheStatistics(results);
+
+        return results;
+    }
+
+    EquivalenceCheckingResults SimulationBasedEquivalenceChecker::checkParallel(const Configuration& config) {
+        checkBackend(config);
+        if (config.simulationBackend != SimulationBackend::DecisionDiagram) {
+            throw std::invalid_argument("Parallel simulation is only supported by the DD simulation backend.");
+        }
+        if (!config.simulationCacheDirectory.empty()) {
+            throw std::invalid_argument("Parallel simulation does not support the simulation cache.");
+        }
+        ToleranceGuard             guard(config.tolerance);
+        EquivalenceCheckingResults results{};
+        setupResults(results);
+        results.stimuliType = config.stimuliType;
+        resetStimuli(config);
+        results.equivalence = Equivalence::ProbablyEquivalent;
+
+        auto start = std::chrono::steady_clock::now();
+        runPreCheckPasses(config);
+        setupGuidedStimuli(config, results);
+        auto endPreprocessing = std::chrono::steady_clock::now();
+
+        // classical stimuli are drawn without replacement, so there are at most 2^n of them
+        auto maxSims = config.max_sims;
+        if (config.stimuliType == StimuliType::Classical && !guidedStimuli) {
+            maxSims = static_cast<std::size_t>(std::min<std::uint64_t>(maxSims, numberOfClassicalStimuli()));
+        }
+
+        std::atomic<std::size_t> claimed{0U};
+        std::atomic<bool>        done{false};
+        std::mutex               resultMutex;
+        std::exception_ptr       error{};
+
+        const auto worker = [&]() {
+            try {
+                // every worker simulates its own copies of the circuits in its own package
+                auto             package = std::make_unique<dd::Package>(nqubits);
+                auto             ops1    = cloneOperations(qc1);
+                auto             ops2    = cloneOperations(qc2);
+                GarbageCollector collector{config};
+                ResourceLimits   limits{config};
+
+                while (!done.load() && claimed.fetch_add(1U) < maxSims) {
+                    auto stimulus = generateRandomStimulus(config.stimuliType, package);
+                    package->incRef(stimulus);
+                    Approximation approximation1{config.approximationNodeBudget};
+                    Approximation approximation2{config.approximationNodeBudget};
+                    bool          completed1 = false;
+                    bool          completed2 = false;
+                    auto          e          = simulate(stimulus, ops1, initial1, output1, garbage1, package, collector, limits, done, &approximation1, &completed1);
+                    auto          f          = simulate(stimulus, ops2, initial2, output2, garbage2, package, collector, limits, done, &approximation2, &completed2);
+                    if (limits.hit) {
+                        std::lock_guard lock(resultMutex);
+                        done.store(true);
+                    }
+
+                    // only simulations cut short (by another worker or a resource limit) are not counted
+                    if (completed1 && completed2) {
+                        const auto      fidelity = package->fidelity(e, f);
+                        std::lock_guard lock(resultMutex);
+                        results.nsims++;
+                        // a counterexample found by another worker is kept
+                        if (results.equivalence != Equivalence::NotEquivalent) {
+                            results.fidelity = fidelity;
+                            storeApproximation(results, approximation1, approximation2);
+                            if (results.fidelityUpperBound < config.fidelity_limit) {
+                                results.equivalence = Equivalence::NotEquivalent;
+                                if (config.storeCEXinput) {
+                                    results.cexInput = package->getVector(stimulus);
+                                }
+                                if (config.storeCEXoutput) {
+                                    results.circuit1.cexOutput = package->getVector(e);
+                                    results.circuit2.cexOutput = package->getVector(f);
+                                }
+                                done.store(true);
+                            } else if (results.fidelityLowerBound < config.fidelity_limit) {
+                                // the approximation is too coarse to decide whether the outputs differ
+                                results.equivalence = Equivalence::NoInformation;
+                                done.store(true);
+                            } else if (results.equivalence == Equivalence::ProbablyEquivalent && config.stimuliType == StimuliType::Classical && !guidedStimuli && results.nsims == numberOfClassicalStimuli()) {
+                                results.equivalence = Equivalence::Equivalent;
+                                done.store(true);
+                            }
+                        }
+                    }
+                    package->decRef(e);
+                    package->decRef(f);
+                    package->decRef(stimulus);
+                    package->garbageCollect();
+                }
+
+                std::lock_guard lock(resultMutex);
+                results.maxActive = std::max(results.maxActive, package->vUniqueTable.getMaxActiveNodes());
+                garbageCollector.merge(collector);
+                resourceLimits.merge(limits);
+            } catch (...) {
+                std::lock_guard lock(resultMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                done.store(true);
+            }
+        };
+
+        const auto               nworkers = std::min(config.nthreads, maxSims);
+        std::vector<std::thread> workers{};
+        workers.reserve(nworkers);
+        for (std::size_t t = 0U; t < nworkers; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w: workers) {
+            w.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        auto                          endVerification   = std::chrono::steady_clock::now();
+        std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+        std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+        results.preprocessingTime                       = preprocessingTime.count();
+        results.verificationTime                        = verificationTime.count();
+        storeStatistics(results);
+
+        return results;
+    }
+
+    EquivalenceCheckingResults SimulationBasedEquivalenceChecker::checkAdaptive(const Configuration& config) {
+        ToleranceGuard             guard(config.tolerance);
+        EquivalenceCheckingResults results{};
+        setupResults(results);
+        results.stimuliType     = config.stimuliType;
+        results.adaptiveStimuli = true;
+        resetStimuli(config);
+        results.equivalence = Equivalence::ProbablyEquivalent;
+
+        auto start = std::chrono::steady_clock::now();
+        runPreCheckPasses(config);
+        setupConcurrentSimulation(config);
+        setupDenseSimulation(config);
+        setupSimulationCache(config);
+        setupGuidedStimuli(config, results);
+        auto endPreprocessing = std::chrono::steady_clock::now();
+
+        constexpr std::array<StimuliType, 3> types{StimuliType::Classical, StimuliType::LocalQuantum, StimuliType::GlobalQuantum};
+        const std::array<dd::fp, 3>          detection{config.classicalDetectionProbability, config.localQuantumDetectionProbability, config.globalQuantumDetectionProbability};
+
+        struct TypeStatistics {
+            std::size_t nsims = 0U;
+            dd::fp      time  = 0.;
+            dd::fp      mean  = 0.;
+            dd::fp      m2    = 0.;
+        };
+        std::array<TypeStatistics, 3> statistics{};
+
+        // logarithm of the probability that all simulations conducted so far missed an existing non-equivalence
+        dd::fp     logMiss    = 0.;
+        const auto confidence = [&]() { return 1. / (1. + std::exp(logMiss)); };
+        // fidelities spreading in the order of the admissible deviation are as valuable as a certain detection
+        const auto deviation = std::max(1. - config.fidelity_limit, config.tolerance);
+
+        while (results.nsims < config.max_sims && confidence() < config.equivalenceConfidence) {
+            std::size_t next  = types.size();
+            dd::fp      score = -1.;
+            for (std::size_t t = 0U; t < types.size(); ++t) {
+                const auto& stats = statistics[t];
+                // classical stimuli are drawn without replacement
+                if (types[t] == StimuliType::Classical && !guidedStimuli && stats.nsims == numberOfClassicalStimuli()) {
+                    continue;
+                }
+                if (stats.nsims == 0U) {
+                    next = t;
+                    break;
+                }
+                const auto spread = stats.nsims > 1U ? std::sqrt(stats.m2 / static_cast<dd::fp>(stats.nsims - 1U)) : 0.;
+                const auto gain   = -std::log1p(-std::clamp(detection[t], 0., 1.)) + spread / deviation;
+                const auto s      = gain * static_cast<dd::fp>(stats.nsims) / std::max(stats.time, 1e-9);
+                if (s > score) {
+                    score = s;
+                    next  = t;
+                }
+            }
+            if (next == types.size()) {
+                break;
+            }
+
+            auto simulationStart = std::chrono::steady_clock::now();
+            auto stimulus        = generateRandomStimulus(types[next]);
+            dd->incRef(stimulus);
+            compareWithStimulus(stimulus, results, config);
+            dd->decRef(stimulus);
+            if (resourceLimits.hit) {
+                break;
+            }
+
+            const auto fidelity = results.fidelity;
+            results.nsims++;
+            results.simsPerStimuliType[static_cast<std::size_t>(types[next])]++;
+
+            auto&                         stats   = statistics[next];
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - simulationStart;
+            stats.time += elapsed.count();
+            stats.nsims++;
+            const auto delta = fidelity - stats.mean;
+            stats.mean += delta / static_cast<dd::fp>(stats.nsims);
+            stats.m2 += delta * (fidelity - stats.mean);
+            logMiss += std::log1p(-std::clamp(detection[next], 0., 1.));
+
+            bool done = false;
+            if (outputsDiffer(results, config)) {
+                results.equivalence = Equivalence::NotEquivalent;
+                results.stimuliType = types[next];
+                done                = true;
+            } else if (results.fidelityLowerBound < config.fidelity_limit) {
+                // the approximation is too coarse to decide whether the outputs differ
+                results.equivalence = Equivalence::NoInformation;
+                done                = true;
+            } else if (types[next] == StimuliType::Classical && !guidedStimuli && stats.nsims == numberOfClassicalStimuli()) {
+                results.equivalence = Equivalence::Equivalent;
+                done                = true;
+            }
+            if (done) {
+                break;
+            }
+        }
+
+        if (results.equivalence == Equivalence::NotEquivalent || results.equivalence == Equivalence::NoInformation || resourceLimits.hit) {
+            // no confidence is claimed for a check that has been given up
+            results.equivalenceConfidence = 0.;
+        } else if (results.equivalence == Equivalence::Equivalent) {
+            results.equivalenceConfidence = 1.;
+        } else {
+            results.equivalenceConfidence = confidence();
+        }
+
+        auto                          endVerification   = std::chrono::steady_clock::now();
+        std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+        std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+        results.preprocessingTime                       = preprocessingTime.count();
+        results.verificationTime                        = verificationTime.count();
+        results.maxActive                               = std::max(results.maxActive, dd->vUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
+        storeSimulationCacheStatistics(results);
+
+        return results;
+    }
+
+    EquivalenceCheckingResults SimulationBasedEquivalenceChecker::estimateFidelity(const Configuration& config) {
+        checkBackend(config);
+        if (config.approximationNodeBudget > 0U) {
+            throw std::invalid_argument("Approximate simulation would bias the fidelity estimate.");
+        }
+        ToleranceGuard             guard(config.tolerance);
+        EquivalenceCheckingResults results{};
+        setupResults(results);
+        results.stimuliType = config.stimuliType;
+        resetStimuli(config);
+        results.equivalence = Equivalence::ProbablyEquivalent;
+
+        auto start = std::chrono::steady_clock::now();
+        runPreCheckPasses(config);
+        setupConcurrentSimulation(config);
+        setupDenseSimulation(config);
+        setupSimulationCache(config);
+        // biased stimuli would bias the estimate
+        guidedStimuli = false;
+        auto endPreprocessing = std::chrono::steady_clock::now();
+
+        // error probability of the interval, split evenly between the two-sided empirical Bernstein bound (Maurer and Pontil) and
+        // the two-sided Hoeffding bound, such that the tighter of both holds with the requested confidence. Since the stopping
+        // rule looks at the interval after every sample, the n-th look only spends delta / (n (n + 1)) of the error probability,
+        // which sums up to delta over all looks. Hence, the interval holds at whichever sample the estimation stops.
+        const auto delta = std::clamp(1. - config.fidelityConfidence, 1e-12, 1.);
+
+        // running mean and variance (Welford's algorithm)
+        dd::fp mean = 0., m2 = 0., halfWidth = 1.;
+
+        const auto maxClassicalStimuli = numberOfClassicalStimuli();
+        while (results.nsims < config.max_sims) {
+            // classical stimuli are drawn without replacement
+            if (config.stimuliType == StimuliType::Classical && results.nsims == maxClassicalStimuli) {
+                break;
+            }
+            auto stimulus = generateRandomStimulus(config.stimuliType);
+            dd->incRef(stimulus);
+            // only the output states of the current sample are alive at any time
+            compareWithStimulus(stimulus, results, config);
+            dd->decRef(stimulus);
+            if (resourceLimits.hit) {
+                break;
+            }
+
+            const auto fidelity = results.fidelity;
+            if (outputsDiffer(results, config)) {
+                results.equivalence = Equivalence::NotEquivalent;
+            }
+
+            results.nsims++;
+            const auto diff = fidelity - mean;
+            mean += diff / static_cast<dd::fp>(results.nsims);
+            m2 += diff * (fidelity - mean);
+
+            if (results.nsims >= 2U) {
+                const auto n            = static_cast<dd::fp>(results.nsims);
+                const auto deltaN       = delta / (n * (n + 1.));
+                const auto bernsteinLog = std::log(8. / deltaN);
+                const auto hoeffdingLog = std::log(4. / deltaN);
+                const auto variance     = m2 / (n - 1.);
+                const auto bernstein    = std::sqrt(2. * variance * bernsteinLog / n) + 7. * bernsteinLog / (3. * (n - 1.));
+                const auto hoeffding    = std::sqrt(hoeffdingLog / (2. * n));
+                halfWidth               = std::min({bernstein, hoeffding, 1.});
+                if (results.nsims >= config.fidelityMinSims && 2. * halfWidth < config.fidelityCIWidth) {
+                    break;
+                }
+            }
+        }
+
+        results.fidelityEstimated = true;
+        results.fidelityEstimate  = mean;
+        results.fidelity          = mean;
+        results.ciLow             = std::max(0., mean - halfWidth);
+        results.ciHigh            = std::min(1., mean + halfWidth);
+
+        auto                          endVerification   = std::chrono::steady_clock::now();
+        std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+        std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+        results.preprocessingTime                       = preprocessingTime.count();
+        results.verificationTime                        = verificationTime.count();
+        results.maxActive                               = std::max(results.maxActive, dd->vUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
+        storeSimulationCacheStatistics(results);
+
+        return results;
+    }
+
+    std::vector<EquivalenceCheckingResults> SimulationBasedEquivalenceChecker::checkCandidates(qc::QuantumComputation& reference, const std::vector<std::reference_wrapper<qc::QuantumComputation>>& candidates, const Configuration& config, std::size_t seed) {
+        if (config.simulationBackend != SimulationBackend::DecisionDiagram || config.approximationNodeBudget > 0U) {
+            throw std::invalid_argument("Checking several candidates is only supported by the exact DD simulation backend.");
+        }
+        // these passes rewrite both circuits of a pair depending on each other, which is impossible for a shared reference
+        if (config.cancelMiterGates || config.stripCommonGates) {
+            throw std::invalid_argument("Checking several candidates does not support cancelling miter gates or stripping common gates.");
+        }
+        if (config.differenceGuidedStimuli || config.adaptiveStimuli || config.estimateFidelity || config.nthreads > 1 || config.concurrentCircuitSimulation) {
+            throw std::invalid_argument("Checking several candidates does not support guided or adaptive stimuli, fidelity estimation, or simulations on several threads.");
+        }
+        if (candidates.empty()) {
+            return {};
+        }
+
+        // the constructor pads the smaller of both circuits with ancillaries, which must never be the shared reference
+        reference.stripIdleQubits();
+        for (const auto& candidate: candidates) {
+            candidate.get().stripIdleQubits();
+            if (candidate.get().getNqubits() > reference.getNqubits()) {
+                throw std::invalid_argument("No candidate may act on more qubits than the reference.");
+            }
+        }
+
+        ToleranceGuard                          guard(config.tolerance);
+        std::vector<EquivalenceCheckingResults> results(candidates.size());
+
+        // the first candidate is simulated in the package of the reference, every other one in a package of its own that
+        // only lives while the candidate is checked
+        auto ref = std::make_unique<SimulationBasedEquivalenceChecker>(reference, candidates.front().get(), seed);
+
+        // the reference is shared by all checkers, so only the one simulating it runs the passes on it
+        auto candidateConfig                             = config;
+        candidateConfig.removeDiagonalGatesBeforeMeasure = false;
+        candidateConfig.reconstructSWAPs                 = false;
+        candidateConfig.fuseSingleQubitGates             = false;
+
+        // stimuli and the corresponding outputs of the reference are retained for the whole batch
+        std::vector<qc::VectorDD> stimuli{};
+        std::vector<qc::VectorDD> outputs{};
+
+        for (std::size_t i = 0U; i < candidates.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+
+            std::unique_ptr<SimulationBasedEquivalenceChecker> own{};
+            if (i == 0U) {
+                ref->runPreCheckPasses(config);
+                ref->setupSimulationCache(config);
+                ref->resetStimuli(config);
+            } else {
+                own = std::make_unique<SimulationBasedEquivalenceChecker>(reference, candidates[i].get(), seed);
+                if (own->nqubits != ref->nqubits || own->initial1 != ref->initial1 || own->output1 != ref->output1 || own->garbage1 != ref->garbage1) {
+                    throw std::invalid_argument("All candidates have to act on the same number of qubits and leave the reference unchanged.");
+                }
+                if (config.removeDiagonalGatesBeforeMeasure) {
+                    qc::CircuitOptimizer::removeDiagonalGatesBeforeMeasure(own->qc2);
+                }
+                if (config.reconstructSWAPs) {
+                    qc::CircuitOptimizer::swapReconstruction(own->qc2);
+                }
+                if (config.fuseSingleQubitGates) {
+                    qc::CircuitOptimizer::singleQubitGateFusion(own->qc2);
+                }
+                own->runPreCheckPasses(candidateConfig);
+            }
+            auto& checker = (i == 0U) ? ref : own;
+            auto& result  = results[i];
+            checker->setupResults(result);
+            result.stimuliType = config.stimuliType;
+
+            const auto                    endPreprocessing  = std::chrono::steady_clock::now();
+            std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+            result.preprocessingTime                        = preprocessingTime.count();
+            start                                           = endPreprocessing;
+
+            bool done = false;
+            for (std::size_t k = 0U; !done && k < config.max_sims; ++k) {
+                if (k == stimuli.size()) {
+                    auto stimulus = ref->generateRandomStimulus(config.stimuliType);
+                    ref->dd->incRef(stimulus);
+                    stimuli.emplace_back(stimulus);
+                    outputs.emplace_back(ref->simulateFirstCircuit(stimulus));
+                }
+                const auto& stimulus = stimuli[k];
+                const auto& e        = outputs[k];
+                if (ref->resourceLimits.hit) {
+                    // the output of the reference is incomplete
+                    checker->resourceLimits.merge(ref->resourceLimits);
+                    break;
+                }
+
+                // the candidate is simulated in its own package
+                auto in = (i == 0U) ? stimulus : transfer(stimulus, checker->dd);
+                checker->dd->incRef(in);
+                auto f = checker->simulate(in, checker->qc2, checker->initial2, checker->output2, checker->garbage2);
+                if (checker->resourceLimits.hit) {
+                    checker->dd->decRef(f);
+                    checker->dd->decRef(in);
+                    break;
+                }
+
+                result.fidelity = ec::fidelity(e, f);
+                result.nsims++;
+                if (result.fidelity < config.fidelity_limit) {
+                    result.equivalence = Equivalence::NotEquivalent;
+                    if (config.storeCEXinput) {
+                        result.cexInput = ref->dd->getVector(stimulus);
+                    }
+                    if (config.storeCEXoutput) {
+                        result.circuit1.cexOutput = ref->dd->getVector(e);
+                        result.circuit2.cexOutput = checker->dd->getVector(f);
+                    }
+                    done = true;
+                } else if (config.stimuliType == StimuliType::Classical && result.nsims == ref->numberOfClassicalStimuli()) {
+                    result.equivalence = Equivalence::Equivalent;
+                    done               = true;
+                } else {
+                    result.equivalence = Equivalence::ProbablyEquivalent;
+                }
+
+                checker->dd->decRef(f);
+                checker->dd->decRef(in);
+                checker->dd->garbageCollect();
+            }
+
+            std::chrono::duration<double> verificationTime = std::chrono::steady_clock::now() - start;
+            result.verificationTime                        = verificationTime.count();
+            result.maxActive                               = std::max(checker->dd->vUniqueTable.getMaxActiveNodes(), ref->dd->vUniqueTable.getMaxActiveNodes());
+            checker->storeStatistics(result);
+        }
+
+        for (std::size_t k = 0U; k < stimuli.size(); ++k) {
+            ref->dd->decRef(outputs[k]);
+            ref->dd->decRef(stimuli[k]);
+        }
+        ref->dd->garbageCollect();
 
         return results;
     }
 
     void SimulationBasedEquivalenceChecker::checkWithStimulus(const qc::VectorDD& stimulus, EquivalenceCheckingResults& results, const Configuration& config) {
+        checkBackend(config);
+        ToleranceGuard guard(config.tolerance);
+
         auto start = std::chrono::steady_clock::now();
         runPreCheckPasses(config);
+        setupConcurrentSimulation(config);
+        setupDenseSimulation(config);
+        setupSimulationCache(config);
         auto endPreprocessing = std::chrono::steady_clock::now();
 
         dd->incRef(stimulus);
@@ -185,6 +1252,8 @@ namespace ec {
         results.preprocessingTime += preprocessingTime.count();
         results.verificationTime += verificationTime.count();
         results.maxActive = std::max(results.maxActive, dd->vUniqueTable.getMaxActiveNodes());
+        storeStatistics(results);
+        storeSimulationCacheStatistics(results);
     }
 
     EquivalenceCheckingResults SimulationBasedEquivalenceChecker::checkZeroState(const Configuration& config) {
@@ -0,0 +1,246 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "SimulationCache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ec {
+    using vNode = dd::Package::vNode;
+
+    namespace {
+        constexpr std::array<char, 8> MAGIC{'Q', 'C', 'E', 'C', 'V', 'D', 'D', '1'};
+        // index referring to the terminal node
+        constexpr std::uint32_t TERMINAL = 0U;
+
+        template<class T>
+        void write(std::ostream& os, const T& value) {
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<class T>
+        T read(std::istream& is) {
+            T value{};
+            if (!is.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+                throw std::runtime_error("Unexpected end of serialized vector DD.");
+            }
+            return value;
+        }
+
+        void writeWeight(std::ostream& os, const dd::Complex& w) {
+            write(os, dd::CTEntry::val(w.r));
+            write(os, dd::CTEntry::val(w.i));
+        }
+    } // namespace
+
+    SimulationCache::SimulationCache(std::filesystem::path directory, std::uintmax_t maxBytes):
+        directory(std::move(directory)), maxBytes(maxBytes) {
+        std::filesystem::create_directories(this->directory);
+    }
+
+    void SimulationCache::serialize(const qc::VectorDD& e, std::ostream& os) {
+        // nodes are numbered in post-order, so the successors of a node are always written before the node itself
+        std::unordered_map<const vNode*, std::uint32_t> index{};
+        std::vector<const vNode*>                       order{};
+
+        const std::function<void(const vNode*)> visit = [&](const vNode* p) {
+            if (vNode::isTerminal(p) || index.count(p) > 0U) {
+                return;
+            }
+            for (const auto& child: p->e) {
+                if (!child.w.approximatelyZero()) {
+                    visit(child.p);
+                }
+            }
+            order.emplace_back(p);
+            index.emplace(p, static_cast<std::uint32_t>(order.size()));
+        };
+        if (!e.w.approximatelyZero()) {
+            visit(e.p);
+        }
+
+        const auto writeEdge = [&](const qc::VectorDD& edge) {
+            if (edge.w.approximatelyZero() || vNode::isTerminal(edge.p)) {
+                write(os, TERMINAL);
+            } else {
+                write(os, index.at(edge.p));
+            }
+            writeWeight(os, edge.w);
+        };
+
+        write(os, static_cast<std::uint32_t>(order.size()));
+        for (const auto* p: order) {
+            write(os, static_cast<std::int16_t>(p->v));
+            for (const auto& child: p->e) {
+                writeEdge(child);
+            }
+        }
+        writeEdge(e);
+    }
+
+    qc::VectorDD SimulationCache::deserialize(std::istream& is, std::unique_ptr<dd::Package>& package) {
+        const auto readEdge = [&](const std::vector<qc::VectorDD>& nodes) {
+            const auto i  = read<std::uint32_t>(is);
+            const auto re = read<dd::fp>(is);
+            const auto im = read<dd::fp>(is);
+            if (i > nodes.size()) {
+                throw std::runtime_error("Invalid node reference in serialized vector DD.");
+            }
+            if (re == 0. && im == 0.) {
+                return qc::VectorDD::zero;
+            }
+            // the edge to a rebuilt node may carry a weight due to normalization
+            const auto& sub = (i == TERMINAL) ? qc::VectorDD::terminal(dd::Complex::one) : nodes[i - 1U];
+            const auto  w   = std::complex<dd::fp>{re, im} * std::complex<dd::fp>{dd::CTEntry::val(sub.w.r), dd::CTEntry::val(sub.w.i)};
+            return qc::VectorDD{sub.p, package->cn.lookup(w.real(), w.imag())};
+        };
+
+        const auto                nnodes = read<std::uint32_t>(is);
+        std::vector<qc::VectorDD> nodes{};
+        nodes.reserve(nnodes);
+        for (std::uint32_t n = 0U; n < nnodes; ++n) {
+            const auto                  level = read<std::int16_t>(is);
+            std::array<qc::VectorDD, 2> edges{};
+            for (auto& edge: edges) {
+                edge = readEdge(nodes);
+            }
+            nodes.emplace_back(package->makeDDNode(static_cast<dd::Qubit>(level), edges));
+        }
+        return readEdge(nodes);
+    }
+
+    std::uint64_t SimulationCache::hash(const qc::VectorDD& e) {
+        std::ostringstream ss{};
+        serialize(e, ss);
+        return hash(ss.str());
+    }
+
+    std::uint64_t SimulationCache::hash(const std::string& bytes) {
+        std::uint64_t h = 14695981039346656037ULL;
+        for (const auto c: bytes) {
+            h ^= static_cast<std::uint8_t>(c);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    std::filesystem::path SimulationCache::entry(std::uint64_t circuitHash, dd::fp tolerance, std::uint64_t stimulusHash) const {
+        std::ostringstream key{};
+        write(key, circuitHash);
+        write(key, tolerance);
+        write(key, stimulusHash);
+
+        std::ostringstream name{};
+        name << std::hex << std::setw(16) << std::setfill('0') << hash(key.str()) << EXTENSION;
+        return directory / name.str();
+    }
+
+    bool SimulationCache::load(std::uint64_t circuitHash, dd::fp tolerance, const qc::VectorDD& stimulus, std::unique_ptr<dd::Package>& package, qc::VectorDD& output) {
+        const auto stimulusHash = hash(stimulus);
+        const auto path         = entry(circuitHash, tolerance, stimulusHash);
+
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs.good()) {
+            ++nmisses;
+            return false;
+        }
+        try {
+            std::array<char, MAGIC.size()> magic{};
+            ifs.read(magic.data(), magic.size());
+            // entries of a different circuit or tolerance (hash collisions on the file name) are never used
+            if (magic != MAGIC || read<std::uint64_t>(ifs) != circuitHash || read<dd::fp>(ifs) != tolerance || read<std::uint64_t>(ifs) != stimulusHash) {
+                throw std::runtime_error("Simulation cache entry does not match.");
+            }
+            output = deserialize(ifs, package);
+        } catch (const std::exception&) {
+            ifs.close();
+            std::error_code ec{};
+            std::filesystem::remove(path, ec);
+            ++nmisses;
+            return false;
+        }
+
+        // mark the entry as recently used
+        std::error_code ec{};
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        ++nhits;
+        return true;
+    }
+
+    void SimulationCache::store(std::uint64_t circuitHash, dd::fp tolerance, const qc::VectorDD& stimulus, const qc::VectorDD& output) {
+        const auto stimulusHash = hash(stimulus);
+        const auto path         = entry(circuitHash, tolerance, stimulusHash);
+
+        // write to a temporary file first, so that concurrent readers never observe partially written entries
+        auto          tmp = path;
+        std::ofstream ofs(tmp.concat(".tmp"), std::ios::binary | std::ios::trunc);
+        if (!ofs.good()) {
+            return;
+        }
+        ofs.write(MAGIC.data(), MAGIC.size());
+        write(ofs, circuitHash);
+        write(ofs, tolerance);
+        write(ofs, stimulusHash);
+        serialize(output, ofs);
+        ofs.close();
+        if (!ofs) {
+            std::error_code ec{};
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+        std::error_code ec{};
+        std::filesystem::rename(tmp, path, ec);
+
+        evict();
+    }
+
+    std::uintmax_t SimulationCache::size() const {
+        std::uintmax_t  total = 0U;
+        std::error_code ec{};
+        for (const auto& file: std::filesystem::directory_iterator(directory, ec)) {
+            if (file.is_regular_file(ec) && file.path().extension() == EXTENSION) {
+                total += file.file_size(ec);
+            }
+        }
+        return total;
+    }
+
+    void SimulationCache::evict() {
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::directory_entry>> entries{};
+        std::uintmax_t                                                                             total = 0U;
+        std::error_code                                                                            ec{};
+        for (const auto& file: std::filesystem::directory_iterator(directory, ec)) {
+            if (file.is_regular_file(ec) && file.path().extension() == EXTENSION) {
+                total += file.file_size(ec);
+                entries.emplace_back(file.last_write_time(ec), file);
+            }
+        }
+        if (total <= maxBytes) {
+            return;
+        }
+
+        // remove the least recently used entries first
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (const auto& [time, file]: entries) {
+            if (total <= maxBytes) {
+                break;
+            }
+            const auto bytes = file.file_size(ec);
+            if (std::filesystem::remove(file.path(), ec)) {
+                total -= std::min(total, bytes);
+            }
+        }
+    }
+} // namespace ec
@@ -0,0 +1,136 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "StabilizerEquivalenceChecker.hpp"
+
+namespace ec {
+    bool StabilizerEquivalenceChecker::isClifford(qc::QuantumComputation& qc) {
+        return std::all_of(qc.begin(), qc.end(), [](const auto& op) {
+            switch (op->getType()) {
+                case qc::Measure:
+                case qc::Barrier:
+                case qc::Snapshot:
+                case qc::ShowProbabilities:
+                    return true;
+                default:
+                    return op->isUnitary() && StabilizerTableau::isClifford(*op);
+            }
+        });
+    }
+
+    StabilizerTableau StabilizerEquivalenceChecker::choiState(qc::QuantumComputation& qc, const qc::Permutation& initial, const qc::Permutation& output, const std::vector<bool>& ancillary) const {
+        const auto  n      = static_cast<std::size_t>(nqubits);
+        std::size_t npairs = 0U;
+        for (std::size_t q = 0U; q < n; ++q) {
+            if (!ancillary[q]) {
+                ++npairs;
+            }
+        }
+
+        // qubit q is entangled with the reference qubit n + i (stabilized by XX and ZZ), ancillaries are stabilized by Z
+        StabilizerTableau tableau(n + npairs, n + npairs);
+        std::size_t       row       = 0U;
+        std::size_t       reference = n;
+        for (std::size_t q = 0U; q < n; ++q) {
+            if (ancillary[q]) {
+                tableau.set(row++, q, false, true);
+                continue;
+            }
+            tableau.set(row, q, true, false);
+            tableau.set(row++, reference, true, false);
+            tableau.set(row, q, false, true);
+            tableau.set(row++, reference++, false, true);
+        }
+
+        auto permutation = initial;
+        for (auto it = qc.begin(); it != qc.end(); ++it) {
+            if ((*it)->getType() == qc::Measure) {
+                // Measurements at the end of the circuit are considered NOPs.
+                if (!qc.isLastOperationOnQubit(it, qc.cend())) {
+                    throw std::invalid_argument("Intermediate measurements currently not supported. Defer your measurements to the end.");
+                }
+                continue;
+            }
+            if ((*it)->isUnitary()) {
+                tableau.apply(**it, permutation);
+            }
+        }
+
+        // correct permutation if necessary (analogous to qc::QuantumComputation::changePermutation)
+        for (const auto& [physical, goal]: output) {
+            const auto current = permutation.at(physical);
+            if (current == goal) {
+                continue;
+            }
+            for (auto& [other, logical]: permutation) {
+                if (logical == goal) {
+                    logical = current;
+                    break;
+                }
+            }
+            permutation.at(physical) = goal;
+            tableau.swap(static_cast<std::size_t>(current), static_cast<std::size_t>(goal));
+        }
+        return tableau;
+    }
+
+    EquivalenceCheckingResults StabilizerEquivalenceChecker::check(const Configuration& config) {
+        auto start            = std::chrono::steady_clock::now();
+        auto endPreprocessing = start;
+        {
+            // the guard is released before falling back to the DD checker, which takes its own
+            ToleranceGuard guard(config.tolerance);
+            runPreCheckPasses(config);
+            endPreprocessing = std::chrono::steady_clock::now();
+
+            if (isClifford(qc1) && isClifford(qc2)) {
+                EquivalenceCheckingResults results{};
+                setupResults(results);
+                results.method = Method::Stabilizer;
+
+                // both circuits are applied to the same input states, i.e., a qubit is fixed to |0> if it is an ancillary in either circuit
+                std::vector<bool> ancillary(nqubits);
+                std::vector<bool> garbage(nqubits);
+                for (std::size_t q = 0U; q < ancillary.size(); ++q) {
+                    ancillary[q] = (q < ancillary1.size() && ancillary1[q]) || (q < ancillary2.size() && ancillary2[q]);
+                    garbage[q]   = (q < garbage1.size() && garbage1[q]) || (q < garbage2.size() && garbage2[q]);
+                }
+
+                const auto state1 = choiState(qc1, initial1, output1, ancillary);
+                const auto state2 = choiState(qc2, initial2, output2, ancillary);
+
+                // the tableau does not keep track of global phases
+                if (state1.reducedGenerators(garbage) == state2.reducedGenerators(garbage)) {
+                    results.equivalence = Equivalence::EquivalentUpToGlobalPhase;
+                } else {
+                    results.equivalence = Equivalence::NotEquivalent;
+                }
+
+                storeStatistics(results);
+
+                auto                          endVerification   = std::chrono::steady_clock::now();
+                std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+                std::chrono::duration<double> verificationTime  = endVerification - endPreprocessing;
+                results.preprocessingTime                       = preprocessingTime.count();
+                results.verificationTime                        = verificationTime.count();
+
+                return results;
+            }
+        }
+
+        // the optimization passes have already been applied
+        auto fallback                             = config;
+        fallback.fuseSingleQubitGates             = false;
+        fallback.reconstructSWAPs                 = false;
+        fallback.removeDiagonalGatesBeforeMeasure = false;
+        fallback.cancelMiterGates                 = false;
+        fallback.stripCommonGates                 = false;
+
+        auto                          results           = ImprovedDDEquivalenceChecker::check(fallback);
+        std::chrono::duration<double> preprocessingTime = endPreprocessing - start;
+        results.preprocessingTime += preprocessingTime.count();
+        return results;
+    }
+} // namespace ec
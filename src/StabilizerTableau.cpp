@@ -0,0 +1,574 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "StabilizerTableau.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <complex>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <stdexcept>
+#include <utility>
+
+namespace ec {
+
+    void StabilizerTableau::Generator::multiply(const Generator& other) {
+        // the phase i^k of the product is accumulated bitwise in a two bit counter (cnt2 cnt1) per qubit
+        std::uint64_t cnt1 = 0U;
+        std::uint64_t cnt2 = 0U;
+        for (std::size_t w = 0U; w < x.size(); ++w) {
+            const auto x1 = x[w];
+            const auto z1 = z[w];
+            x[w] ^= other.x[w];
+            z[w] ^= other.z[w];
+            const auto x1z2          = x1 & other.z[w];
+            const auto antiCommuting = (other.x[w] & z1) ^ x1z2;
+            cnt2 ^= (cnt1 ^ x[w] ^ z[w] ^ x1z2) & antiCommuting;
+            cnt1 ^= antiCommuting;
+        }
+        const auto k = std::bitset<64>(cnt1).count() + 2U * std::bitset<64>(cnt2).count();
+        if ((k & 1U) != 0U) {
+            throw std::invalid_argument("Product of anti-commuting generators.");
+        }
+        sign = sign ^ other.sign ^ ((k & 2U) != 0U);
+    }
+
+    StabilizerTableau::StabilizerTableau(std::size_t nqubits, std::size_t nrows):
+        nqubits(nqubits), nrows(nrows), rowWords((nrows + 63U) / 64U), colWords((nqubits + 63U) / 64U),
+        xs(nqubits * rowWords), zs(nqubits * rowWords), signs(rowWords) {}
+
+    void StabilizerTableau::set(std::size_t row, std::size_t q, bool x, bool z) {
+        const auto mask = std::uint64_t{1} << (row % 64U);
+        auto&      xw   = xcol(q)[row / 64U];
+        auto&      zw   = zcol(q)[row / 64U];
+        xw              = x ? (xw | mask) : (xw & ~mask);
+        zw              = z ? (zw | mask) : (zw & ~mask);
+    }
+
+    void StabilizerTableau::setSign(std::size_t row, bool sign) {
+        const auto mask = std::uint64_t{1} << (row % 64U);
+        signs[row / 64U] = sign ? (signs[row / 64U] | mask) : (signs[row / 64U] & ~mask);
+    }
+
+    StabilizerTableau::Generator StabilizerTableau::generator(std::size_t row) const {
+        Generator g{std::vector<std::uint64_t>(colWords), std::vector<std::uint64_t>(colWords), ((signs[row / 64U] >> (row % 64U)) & 1U) != 0U};
+        for (std::size_t q = 0U; q < nqubits; ++q) {
+            const auto bit = std::uint64_t{1} << (q % 64U);
+            if ((xs[q * rowWords + row / 64U] >> (row % 64U)) & 1U) {
+                g.x[q / 64U] |= bit;
+            }
+            if ((zs[q * rowWords + row / 64U] >> (row % 64U)) & 1U) {
+                g.z[q / 64U] |= bit;
+            }
+        }
+        return g;
+    }
+
+    // the gates below conjugate every generator P by the gate U, i.e., P -> U P U^dagger
+
+    void StabilizerTableau::h(std::size_t q) {
+        auto* x = xcol(q);
+        auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w] & z[w];
+            std::swap(x[w], z[w]);
+        }
+    }
+
+    void StabilizerTableau::s(std::size_t q) {
+        auto* x = xcol(q);
+        auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w] & z[w];
+            z[w] ^= x[w];
+        }
+    }
+
+    void StabilizerTableau::sdg(std::size_t q) {
+        auto* x = xcol(q);
+        auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w] & ~z[w];
+            z[w] ^= x[w];
+        }
+    }
+
+    void StabilizerTableau::sx(std::size_t q) {
+        auto* x = xcol(q);
+        auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= z[w] & ~x[w];
+            x[w] ^= z[w];
+        }
+    }
+
+    void StabilizerTableau::sxdg(std::size_t q) {
+        auto* x = xcol(q);
+        auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w] & z[w];
+            x[w] ^= z[w];
+        }
+    }
+
+    void StabilizerTableau::x(std::size_t q) {
+        const auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= z[w];
+        }
+    }
+
+    void StabilizerTableau::y(std::size_t q) {
+        const auto* x = xcol(q);
+        const auto* z = zcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w] ^ z[w];
+        }
+    }
+
+    void StabilizerTableau::z(std::size_t q) {
+        const auto* x = xcol(q);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= x[w];
+        }
+    }
+
+    void StabilizerTableau::cx(std::size_t control, std::size_t target) {
+        auto* xc = xcol(control);
+        auto* zc = zcol(control);
+        auto* xt = xcol(target);
+        auto* zt = zcol(target);
+        for (std::size_t w = 0U; w < rowWords; ++w) {
+            signs[w] ^= xc[w] & zt[w] & ~(xt[w] ^ zc[w]);
+            xt[w] ^= xc[w];
+            zc[w] ^= zt[w];
+        }
+    }
+
+    void StabilizerTableau::cy(std::size_t control, std::size_t target) {
+        sdg(target);
+        cx(control, target);
+        s(target);
+    }
+
+    void StabilizerTableau::cz(std::size_t a, std::size_t b) {
+        h(b);
+        cx(a, b);
+        h(b);
+    }
+
+    void StabilizerTableau::swap(std::size_t a, std::size_t b) {
+        std::swap_ranges(xcol(a), xcol(a) + rowWords, xcol(b));
+        std::swap_ranges(zcol(a), zcol(a) + rowWords, zcol(b));
+    }
+
+    bool StabilizerTableau::quarterTurns(dd::fp angle, unsigned& turns) {
+        const auto k = std::round(angle / dd::PI_2);
+        if (std::abs(angle - k * dd::PI_2) > 1e-12) {
+            return false;
+        }
+        turns = static_cast<unsigned>(((static_cast<long long>(k) % 4) + 4) % 4);
+        return true;
+    }
+
+    bool StabilizerTableau::isCliffordStandardOperation(const qc::Operation& op) {
+        const auto ncontrols = op.getNcontrols();
+        unsigned   turns     = 0U;
+        switch (op.getType()) {
+            case qc::I:
+            case qc::H:
+            case qc::S:
+            case qc::Sdag:
+            case qc::SX:
+            case qc::SXdag:
+            case qc::V:
+            case qc::Vdag:
+                return ncontrols == 0U;
+            case qc::X:
+            case qc::Y:
+            case qc::Z:
+                return ncontrols <= 1U;
+            case qc::SWAP:
+                return ncontrols == 0U;
+            case qc::Phase:
+            case qc::RX:
+            case qc::RY:
+            case qc::RZ:
+                return ncontrols == 0U && quarterTurns(op.getParameter()[0], turns);
+            default:
+                return false;
+        }
+    }
+
+    bool StabilizerTableau::isClifford(const qc::Operation& op) {
+        if (op.isCompoundOperation()) {
+            const auto& compound = dynamic_cast<const qc::CompoundOperation&>(op);
+            return std::all_of(compound.begin(), compound.end(), [](const auto& sub) { return isClifford(*sub); });
+        }
+        return op.isStandardOperation() && isCliffordStandardOperation(op);
+    }
+
+    void StabilizerTableau::apply(const qc::Operation& op, qc::Permutation& permutation) {
+        if (op.isCompoundOperation()) {
+            for (const auto& sub: dynamic_cast<const qc::CompoundOperation&>(op)) {
+                apply(*sub, permutation);
+            }
+            return;
+        }
+        if (!op.isStandardOperation() || !isCliffordStandardOperation(op)) {
+            throw std::invalid_argument("Operation " + op.getName() + " is not supported by the stabilizer tableau.");
+        }
+
+        const auto& targets = op.getTargets();
+        if (op.getType() == qc::SWAP) {
+            std::swap(permutation.at(targets.at(0)), permutation.at(targets.at(1)));
+            return;
+        }
+
+        const auto target = static_cast<std::size_t>(permutation.at(targets.at(0)));
+        if (op.isControlled()) {
+            const auto& control  = *op.getControls().begin();
+            const auto  c        = static_cast<std::size_t>(permutation.at(control.qubit));
+            const bool  negative = control.type != dd::Control::Type::pos;
+            if (negative) {
+                x(c);
+            }
+            switch (op.getType()) {
+                case qc::X:
+                    cx(c, target);
+                    break;
+                case qc::Y:
+                    cy(c, target);
+                    break;
+                default:
+                    cz(c, target);
+                    break;
+            }
+            if (negative) {
+                x(c);
+            }
+            return;
+        }
+
+        unsigned turns = 0U;
+        switch (op.getType()) {
+            case qc::H:
+                h(target);
+                break;
+            case qc::X:
+                x(target);
+                break;
+            case qc::Y:
+                y(target);
+                break;
+            case qc::Z:
+                z(target);
+                break;
+            case qc::S:
+                s(target);
+                break;
+            case qc::Sdag:
+                sdg(target);
+                break;
+            case qc::SX:
+            case qc::V:
+                sx(target);
+                break;
+            case qc::SXdag:
+            case qc::Vdag:
+                sxdg(target);
+                break;
+            case qc::Phase:
+            case qc::RZ:
+                quarterTurns(op.getParameter()[0], turns);
+                for (unsigned t = 0U; t < turns; ++t) {
+                    s(target);
+                }
+                break;
+            case qc::RX:
+                quarterTurns(op.getParameter()[0], turns);
+                for (unsigned t = 0U; t < turns; ++t) {
+                    sx(target);
+                }
+                break;
+            case qc::RY:
+                // a quarter turn about the Y axis equals Z followed by H (up to a global phase)
+                quarterTurns(op.getParameter()[0], turns);
+                for (unsigned t = 0U; t < turns; ++t) {
+                    z(target);
+                    h(target);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool StabilizerTableau::rowReduce(std::vector<Generator>& rows, const std::vector<std::size_t>& order) {
+        std::size_t pivot = 0U;
+        for (std::size_t i = 0U; i < order.size() && pivot < rows.size(); ++i) {
+            for (const bool xPart: {true, false}) {
+                const auto q   = order[i];
+                const auto bit = [&](const Generator& g) { return xPart ? g.getX(q) : g.getZ(q); };
+                auto       it  = std::find_if(rows.begin() + static_cast<std::ptrdiff_t>(pivot), rows.end(), bit);
+                if (it == rows.end()) {
+                    continue;
+                }
+                std::iter_swap(rows.begin() + static_cast<std::ptrdiff_t>(pivot), it);
+                for (std::size_t r = 0U; r < rows.size(); ++r) {
+                    if (r != pivot && bit(rows[r])) {
+                        rows[r].multiply(rows[pivot]);
+                    }
+                }
+                ++pivot;
+            }
+        }
+
+        // all remaining rows are (signed) identities
+        const bool consistent = std::none_of(rows.begin() + static_cast<std::ptrdiff_t>(pivot), rows.end(), [](const Generator& g) { return g.sign; });
+        rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(pivot), rows.end());
+        return consistent;
+    }
+
+    std::vector<StabilizerTableau::Generator> StabilizerTableau::reducedGenerators(const std::vector<bool>& traced) const {
+        std::vector<Generator> rows{};
+        rows.reserve(nrows);
+        for (std::size_t r = 0U; r < nrows; ++r) {
+            rows.emplace_back(generator(r));
+        }
+
+        // eliminate the columns of the traced qubits first, so that the remaining rows act trivially on them
+        std::vector<std::size_t> order{};
+        order.reserve(nqubits);
+        for (std::size_t q = 0U; q < nqubits; ++q) {
+            if (q < traced.size() && traced[q]) {
+                order.emplace_back(q);
+            }
+        }
+        for (std::size_t q = 0U; q < nqubits; ++q) {
+            if (q >= traced.size() || !traced[q]) {
+                order.emplace_back(q);
+            }
+        }
+        rowReduce(rows, order);
+
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [&](const Generator& g) {
+                       for (std::size_t q = 0U; q < traced.size() && q < nqubits; ++q) {
+                           if (traced[q] && (g.getX(q) || g.getZ(q))) {
+                               return true;
+                           }
+                       }
+                       return false;
+                   }),
+                   rows.end());
+        return rows;
+    }
+
+    StabilizerTableau StabilizerTableau::zeroState(std::size_t nqubits) {
+        StabilizerTableau tableau(nqubits, nqubits);
+        for (std::size_t q = 0U; q < nqubits; ++q) {
+            tableau.set(q, q, false, true);
+        }
+        return tableau;
+    }
+
+    void StabilizerTableau::randomize(std::size_t nactive, std::size_t depth, std::mt19937_64& mt) {
+        std::vector<std::size_t> qubits(nactive);
+        std::iota(qubits.begin(), qubits.end(), 0U);
+        for (std::size_t layer = 0U; layer < depth; ++layer) {
+            for (std::size_t q = 0U; q < nactive; ++q) {
+                // uniformly random single-qubit Clifford: one of the six cosets of the Pauli group followed by a Pauli
+                switch (mt() % 6U) {
+                    case 1:
+                        h(q);
+                        break;
+                    case 2:
+                        s(q);
+                        break;
+                    case 3:
+                        h(q);
+                        s(q);
+                        break;
+                    case 4:
+                        s(q);
+                        h(q);
+                        break;
+                    case 5:
+                        h(q);
+                        s(q);
+                        h(q);
+                        break;
+                    default:
+                        break;
+                }
+                switch (mt() % 4U) {
+                    case 1:
+                        x(q);
+                        break;
+                    case 2:
+                        y(q);
+                        break;
+                    case 3:
+                        z(q);
+                        break;
+                    default:
+                        break;
+                }
+            }
+            // entangle randomly paired qubits
+            std::shuffle(qubits.begin(), qubits.end(), mt);
+            for (std::size_t i = 0U; i + 1U < nactive; i += 2U) {
+                cx(qubits[i], qubits[i + 1U]);
+            }
+        }
+    }
+
+    namespace {
+        using Generator = StabilizerTableau::Generator;
+
+        std::complex<dd::fp> value(const dd::Complex& c) {
+            return {dd::CTEntry::val(c.r), dd::CTEntry::val(c.i)};
+        }
+
+        /// Amplitude of the basis state (given by one bit per qubit) in the vector DD
+        std::complex<dd::fp> amplitude(const qc::VectorDD& e, const std::vector<bool>& bits) {
+            auto a = value(e.w);
+            auto p = e.p;
+            while (!dd::Package::vNode::isTerminal(p) && a != 0.) {
+                const auto& child = p->e[bits[static_cast<std::size_t>(p->v)] ? 1U : 0U];
+                a *= value(child.w);
+                p = child.p;
+            }
+            return a;
+        }
+
+        /// Some basis state with a non-zero amplitude in the (non-zero) vector DD
+        std::vector<bool> support(const qc::VectorDD& e, std::size_t nqubits) {
+            std::vector<bool> bits(nqubits);
+            auto              p = e.p;
+            while (!dd::Package::vNode::isTerminal(p)) {
+                const bool one                       = p->e[0].w.approximatelyZero();
+                bits[static_cast<std::size_t>(p->v)] = one;
+                p                                    = p->e[one ? 1U : 0U].p;
+            }
+            return bits;
+        }
+
+        /// Builds the vector DD of a stabilizer state from the bottom up. The cofactor of a stabilizer state w.r.t. its
+        /// topmost qubit is again a stabilizer state (or zero), so every node corresponds to a canonical set of generators.
+        class StateBuilder {
+        public:
+            StateBuilder(std::unique_ptr<dd::Package>& dd, std::size_t nqubits):
+                dd(dd), nqubits(nqubits), memo(nqubits) {}
+
+            /// Vector DD (up to a scalar) of the state stabilized by the rows acting on the qubits 0, ..., k-1
+            qc::VectorDD build(std::vector<Generator> rows, std::size_t k) {
+                std::vector<std::size_t> order(k);
+                std::iota(order.rbegin(), order.rend(), 0U);
+                if (!StabilizerTableau::rowReduce(rows, order)) {
+                    return qc::VectorDD::zero;
+                }
+                if (k == 0U) {
+                    return qc::VectorDD::terminal(dd::Complex::one);
+                }
+
+                std::string key{};
+                for (const auto& g: rows) {
+                    key.append(reinterpret_cast<const char*>(g.x.data()), g.x.size() * sizeof(std::uint64_t));
+                    key.append(reinterpret_cast<const char*>(g.z.data()), g.z.size() * sizeof(std::uint64_t));
+                    key.push_back(g.sign ? '-' : '+');
+                }
+                auto& level = memo[k - 1U];
+                if (const auto it = level.find(key); it != level.end()) {
+                    return it->second;
+                }
+
+                // after the reduction, at most one row has an X (or Y) on the topmost qubit and at most one other row a Z
+                const auto             t = k - 1U;
+                const Generator*       g1{};
+                std::vector<Generator> group0{};
+                std::vector<Generator> group1{};
+                for (const auto& g: rows) {
+                    if (g.getX(t)) {
+                        g1 = &g;
+                    } else if (g.getZ(t)) {
+                        // s Z (x) P stabilizes the cofactors |0> (x) psi0 and |1> (x) psi1 iff s P psi0 = psi0 and -s P psi1 = psi1
+                        auto p = g;
+                        p.z[t / 64U] &= ~(std::uint64_t{1} << (t % 64U));
+                        group0.emplace_back(p);
+                        p.sign = !p.sign;
+                        group1.emplace_back(p);
+                    } else {
+                        group0.emplace_back(g);
+                        group1.emplace_back(g);
+                    }
+                }
+
+                std::array<qc::VectorDD, 2> edges{build(group0, t), build(group1, t)};
+                if (g1 != nullptr) {
+                    // s X (x) P (or s Y (x) P) maps psi0 to psi1 = c P psi0 with c = s (or c = i s, respectively)
+                    auto p = *g1;
+                    p.x[t / 64U] &= ~(std::uint64_t{1} << (t % 64U));
+                    p.z[t / 64U] &= ~(std::uint64_t{1} << (t % 64U));
+                    std::complex<dd::fp> c = p.sign ? -1. : 1.;
+                    if (g1->getZ(t)) {
+                        c *= std::complex<dd::fp>{0., 1.};
+                    }
+
+                    // compare both sides of psi1 = c P psi0 for a basis state in the support of psi1
+                    const auto bits    = support(edges[1], nqubits);
+                    auto       flipped = bits;
+                    for (std::size_t q = 0U; q < t; ++q) {
+                        const bool x = p.getX(q);
+                        const bool z = p.getZ(q);
+                        if (x && z) {
+                            c *= std::complex<dd::fp>{0., 1.};
+                        }
+                        if (x) {
+                            flipped[q] = !flipped[q];
+                        }
+                        if (z && flipped[q]) {
+                            c = -c;
+                        }
+                    }
+                    const auto w = c * amplitude(edges[0], flipped) / amplitude(edges[1], bits) * value(edges[1].w);
+                    edges[1].w   = dd->cn.lookup(w.real(), w.imag());
+                }
+
+                auto e = dd->makeDDNode(static_cast<dd::Qubit>(t), edges);
+                level.emplace(std::move(key), e);
+                return e;
+            }
+
+        protected:
+            std::unique_ptr<dd::Package>&                               dd;
+            std::size_t                                                 nqubits;
+            std::vector<std::unordered_map<std::string, qc::VectorDD>> memo;
+        };
+    } // namespace
+
+    qc::VectorDD StabilizerTableau::toVectorDD(std::unique_ptr<dd::Package>& dd) const {
+        if (nrows != nqubits) {
+            throw std::invalid_argument("A stabilizer state requires as many generators as qubits.");
+        }
+        std::vector<Generator> rows{};
+        rows.reserve(nrows);
+        for (std::size_t r = 0U; r < nrows; ++r) {
+            rows.emplace_back(generator(r));
+        }
+
+        StateBuilder builder(dd, nqubits);
+        auto         e = builder.build(rows, nqubits);
+
+        // normalize the state
+        const auto norm = std::sqrt(dd->innerProduct(e, e).r);
+        const auto w    = value(e.w) / norm;
+        e.w             = dd->cn.lookup(w.real(), w.imag());
+        return e;
+    }
+} // namespace ec
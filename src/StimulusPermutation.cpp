@@ -0,0 +1,68 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "StimulusPermutation.hpp"
+
+namespace ec {
+
+    StimulusPermutation::StimulusPermutation(std::size_t nbits, std::uint64_t key):
+        nbits(nbits), lowerBits(nbits / 2U), upperBits(nbits - nbits / 2U) {
+        for (std::size_t r = 0U; r < ROUNDS; ++r) {
+            roundKeys[r] = mix(key + (r + 1U) * 0x9e3779b97f4a7c15ULL);
+        }
+    }
+
+    std::vector<bool> StimulusPermutation::operator()(std::uint64_t index) const {
+        Half lower((lowerBits + 63U) / 64U);
+        Half upper((upperBits + 63U) / 64U);
+
+        // split the (zero-extended) index into both halves
+        if (lowerBits >= 64U) {
+            lower[0] = index;
+        } else {
+            if (lowerBits > 0U) {
+                lower[0] = index & ((std::uint64_t{1} << lowerBits) - 1U);
+            }
+            if (!upper.empty()) {
+                upper[0] = index >> lowerBits;
+            }
+        }
+
+        for (std::size_t r = 0U; r < ROUNDS; ++r) {
+            if (r % 2U == 0U) {
+                round(lower, upper, upperBits, roundKeys[r]);
+            } else {
+                round(upper, lower, lowerBits, roundKeys[r]);
+            }
+        }
+
+        std::vector<bool> result(nbits);
+        for (std::size_t i = 0U; i < lowerBits; ++i) {
+            result[i] = ((lower[i / 64U] >> (i % 64U)) & 1U) != 0U;
+        }
+        for (std::size_t i = 0U; i < upperBits; ++i) {
+            result[lowerBits + i] = ((upper[i / 64U] >> (i % 64U)) & 1U) != 0U;
+        }
+        return result;
+    }
+
+    void StimulusPermutation::round(const Half& src, Half& dst, std::size_t dstBits, std::uint64_t roundKey) {
+        if (dst.empty()) {
+            return;
+        }
+
+        auto h = roundKey;
+        for (const auto word: src) {
+            h = mix(h ^ word);
+        }
+        // expand the hash to the width of the destination half in counter mode
+        for (std::size_t j = 0U; j < dst.size(); ++j) {
+            dst[j] ^= mix(h + (j + 1U) * 0x9e3779b97f4a7c15ULL);
+        }
+        if (dstBits % 64U != 0U) {
+            dst.back() &= (std::uint64_t{1} << (dstBits % 64U)) - 1U;
+        }
+    }
+} // namespace ec
@@ -0,0 +1,206 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "TraceEngine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace ec {
+
+    TraceEngine::TraceEngine(std::size_t initialCapacity) {
+        std::size_t cap = 16U;
+        while (cap < initialCapacity) {
+            cap <<= 1U;
+        }
+        table.resize(cap);
+    }
+
+    std::complex<dd::fp> TraceEngine::trace(const qc::MatrixDD& e, dd::QubitCount nqubits) {
+        clear();
+        // levels above the root node are not explicitly represented and each contribute a factor of two
+        return edgeTrace(e, static_cast<dd::Qubit>(nqubits));
+    }
+
+    std::complex<dd::fp> TraceEngine::traceParallel(const qc::MatrixDD& e, dd::QubitCount nqubits, std::size_t nthreads) {
+        clear();
+        if (e.w.approximatelyZero()) {
+            return {};
+        }
+        if (mNode::isTerminal(e.p)) {
+            return scale(e, static_cast<dd::Qubit>(nqubits), {1., 0.});
+        }
+
+        // collect the nodes of the diagonal sub-DD level by level using an explicit stack
+        std::vector<std::vector<const mNode*>> levels(static_cast<std::size_t>(e.p->v) + 1U);
+        std::vector<const mNode*>              stack{e.p};
+        emplace(e.p);
+        while (!stack.empty()) {
+            const auto* p = stack.back();
+            stack.pop_back();
+            levels[static_cast<std::size_t>(p->v)].push_back(p);
+            for (const auto i: {0U, 3U}) {
+                const auto& child = p->e[i];
+                if (!mNode::isTerminal(child.p) && !child.w.approximatelyZero() && emplace(child.p)) {
+                    stack.push_back(child.p);
+                }
+            }
+        }
+
+        // all successors of a node reside at lower levels, so the nodes of a level can be evaluated independently
+        // once all lower levels are done. The memo table is not modified structurally during this phase, so every
+        // thread only writes to the entries of the nodes it evaluates and reads entries of already completed levels.
+        std::vector<std::thread> workers{};
+        for (const auto& level: levels) {
+            const auto nodes = level.size();
+            if (nthreads <= 1U || nodes < 2U * PARALLEL_GRAIN) {
+                for (const auto* p: level) {
+                    evaluate(p);
+                }
+                continue;
+            }
+
+            std::atomic<std::size_t> next{0U};
+            const auto               nworkers = std::min(nthreads, (nodes + PARALLEL_GRAIN - 1U) / PARALLEL_GRAIN);
+            workers.clear();
+            for (std::size_t t = 0U; t < nworkers; ++t) {
+                workers.emplace_back([&]() {
+                    // threads repeatedly grab chunks of the level until it is exhausted
+                    for (auto start = next.fetch_add(PARALLEL_GRAIN); start < nodes; start = next.fetch_add(PARALLEL_GRAIN)) {
+                        const auto stop = std::min(start + PARALLEL_GRAIN, nodes);
+                        for (auto i = start; i < stop; ++i) {
+                            evaluate(level[i]);
+                        }
+                    }
+                });
+            }
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        std::complex<dd::fp> rootTrace{};
+        lookup(e.p, rootTrace);
+        return scale(e, static_cast<dd::Qubit>(nqubits), rootTrace);
+    }
+
+    dd::fp TraceEngine::processFidelity(const std::complex<dd::fp>& trace, dd::QubitCount nqubits) {
+        return std::norm(trace) / std::ldexp(1., 2 * nqubits);
+    }
+
+    void TraceEngine::clear() {
+        if (count == 0U) {
+            return;
+        }
+        std::fill(table.begin(), table.end(), Entry{});
+        count = 0U;
+    }
+
+    std::complex<dd::fp> TraceEngine::edgeTrace(const qc::MatrixDD& e, dd::Qubit parentLevel) {
+        if (e.w.approximatelyZero()) {
+            return {};
+        }
+        return scale(e, parentLevel, nodeTrace(e.p));
+    }
+
+    std::complex<dd::fp> TraceEngine::scale(const qc::MatrixDD& e, dd::Qubit parentLevel, const std::complex<dd::fp>& childTrace) {
+        // the terminal node resides at level -1
+        const auto childLevel = mNode::isTerminal(e.p) ? static_cast<dd::Qubit>(-1) : e.p->v;
+        const auto skipped    = parentLevel - childLevel - 1;
+        auto       result     = value(e.w) * childTrace;
+        if (skipped > 0) {
+            result *= std::ldexp(1., skipped);
+        }
+        return result;
+    }
+
+    std::complex<dd::fp> TraceEngine::nodeTrace(const mNode* p) {
+        if (mNode::isTerminal(p)) {
+            return {1., 0.};
+        }
+
+        std::complex<dd::fp> result{};
+        if (lookup(p, result)) {
+            return result;
+        }
+
+        // only the diagonal successors contribute to the trace
+        result = edgeTrace(p->e[0], p->v) + edgeTrace(p->e[3], p->v);
+        insert(p, result);
+        return result;
+    }
+
+    void TraceEngine::evaluate(const mNode* p) {
+        std::complex<dd::fp> result{};
+        for (const auto i: {0U, 3U}) {
+            const auto& child = p->e[i];
+            if (child.w.approximatelyZero()) {
+                continue;
+            }
+            std::complex<dd::fp> childTrace{1., 0.};
+            if (!mNode::isTerminal(child.p)) {
+                lookup(child.p, childTrace);
+            }
+            result += scale(child, p->v, childTrace);
+        }
+        table[find(p)].value = result;
+    }
+
+    bool TraceEngine::emplace(const mNode* p) {
+        if (2U * (count + 1U) > table.size()) {
+            grow();
+        }
+        auto i = find(p);
+        if (table[i].node != nullptr) {
+            return false;
+        }
+        table[i].node = p;
+        ++count;
+        return true;
+    }
+
+    std::size_t TraceEngine::find(const mNode* p) const {
+        const auto mask = table.size() - 1U;
+        auto       i    = slot(p);
+        while (table[i].node != nullptr && table[i].node != p) {
+            i = (i + 1U) & mask;
+        }
+        return i;
+    }
+
+    bool TraceEngine::lookup(const mNode* p, std::complex<dd::fp>& value) const {
+        const auto& entry = table[find(p)];
+        if (entry.node == nullptr) {
+            return false;
+        }
+        value = entry.value;
+        return true;
+    }
+
+    void TraceEngine::insert(const mNode* p, const std::complex<dd::fp>& value) {
+        // keep the load factor below 1/2 so probe sequences stay short
+        if (2U * (count + 1U) > table.size()) {
+            grow();
+        }
+        auto i = find(p);
+        if (table[i].node == nullptr) {
+            ++count;
+        }
+        table[i] = {p, value};
+    }
+
+    void TraceEngine::grow() {
+        std::vector<Entry> old(table.size() * 2U);
+        old.swap(table);
+        count = 0U;
+        for (const auto& entry: old) {
+            if (entry.node != nullptr) {
+                insert(entry.node, entry.value);
+            }
+        }
+    }
+} // namespace ec
@@ -3,6 +3,7 @@
  * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
  */
 
+#include "CommutationDAG.hpp"
 #include "CompilationFlowEquivalenceChecker.hpp"
 #include "EquivalenceChecker.hpp"
 #include "ImprovedDDEquivalenceChecker.hpp"
@@ -62,6 +63,33 @@ TEST_P(FunctionalityTest, Lookahead) {
     EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
 }
 
+TEST_P(FunctionalityTest, BeamLookahead) {
+    qc_alternative.import(test_alternative_dir + "test_" + GetParam() + ".qasm");
+    ec::ImprovedDDEquivalenceChecker eq_beam(qc_original, qc_alternative);
+    config.strategy = ec::Strategy::BeamLookahead;
+    auto results    = eq_beam.check(config);
+    results.print();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+}
+
+TEST_P(FunctionalityTest, SizeFeedback) {
+    qc_alternative.import(test_alternative_dir + "test_" + GetParam() + ".qasm");
+    ec::ImprovedDDEquivalenceChecker eq_feedback(qc_original, qc_alternative);
+    config.strategy = ec::Strategy::SizeFeedback;
+    auto results    = eq_feedback.check(config);
+    results.print();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+}
+
+TEST_P(FunctionalityTest, Commutation) {
+    qc_alternative.import(test_alternative_dir + "test_" + GetParam() + ".qasm");
+    ec::ImprovedDDEquivalenceChecker eq_commutation(qc_original, qc_alternative);
+    config.strategy = ec::Strategy::Commutation;
+    auto results    = eq_commutation.check(config);
+    results.print();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+}
+
 TEST_P(FunctionalityTest, Naive) {
     qc_alternative.import(test_alternative_dir + "test_" + GetParam() + ".qasm");
     ec::ImprovedDDEquivalenceChecker eq_naive(qc_original, qc_alternative);
@@ -141,3 +169,26 @@ TEST_F(FunctionalityTest, test2) {
     results.print();
     EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
 }
+
+TEST(CommutationDAG, Frontier) {
+    qc::QuantumComputation qc(3);
+    qc.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 1, qc::X); // 0
+    qc.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 2, qc::X); // 1: shares the control with 0
+    qc.emplace_back<qc::StandardOperation>(3, dd::Control{2}, 1, qc::X); // 2: shares the target with 0, but 1 targets its control
+    qc.emplace_back<qc::StandardOperation>(3, 0, qc::T);                 // 3: diagonal on the controls of 0 and 1
+    qc.emplace_back<qc::StandardOperation>(3, 0, qc::H);                 // 4: depends on 0, 1, and 3
+
+    ec::CommutationDAG dag(qc);
+    EXPECT_EQ(dag.frontier(), (std::vector<std::size_t>{0, 1, 3}));
+    EXPECT_EQ(dag.getSuccessors(1), (std::vector<std::size_t>{2, 4}));
+
+    dag.markApplied(1);
+    EXPECT_EQ(dag.frontier(), (std::vector<std::size_t>{0, 2, 3}));
+    EXPECT_THROW(dag.markApplied(4), std::invalid_argument);
+    dag.markApplied(3);
+    dag.markApplied(0);
+    EXPECT_EQ(dag.frontier(), (std::vector<std::size_t>{2, 4}));
+    dag.markApplied(4);
+    dag.markApplied(2);
+    EXPECT_TRUE(dag.done());
+}
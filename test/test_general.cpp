@@ -5,12 +5,15 @@
 
 #include "CompilationFlowEquivalenceChecker.hpp"
 #include "SimulationBasedEquivalenceChecker.hpp"
+#include "TraceEngine.hpp"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using ::testing::HasSubstr;
 
@@ -266,3 +269,352 @@ TEST_F(GeneralTest, FixOutputPermutationMismatch) {
 
     EXPECT_TRUE(results.consideredEquivalent());
 }
+
+TEST_F(GeneralTest, TraceEngine) {
+    auto            dd = std::make_unique<dd::Package>(3);
+    ec::TraceEngine engine{};
+
+    auto ident = dd->makeIdent(3);
+    auto trace = engine.trace(ident, 3);
+    EXPECT_NEAR(trace.real(), 8., 1e-10);
+    EXPECT_NEAR(trace.imag(), 0., 1e-10);
+    EXPECT_NEAR(ec::TraceEngine::processFidelity(trace, 3), 1., 1e-10);
+
+    auto x = dd->makeGateDD(dd::Xmat, 3, 0);
+    EXPECT_NEAR(std::abs(engine.trace(x, 3)), 0., 1e-10);
+
+    // tr(S) = 1 + i on the acted upon qubit
+    auto s = dd->makeGateDD(dd::Smat, 3, 1);
+    trace  = engine.trace(s, 3);
+    EXPECT_NEAR(trace.real(), 4., 1e-10);
+    EXPECT_NEAR(trace.imag(), 4., 1e-10);
+    EXPECT_NEAR(ec::TraceEngine::processFidelity(trace, 3), 0.5, 1e-10);
+}
+
+TEST_F(GeneralTest, ConcurrentCheckers) {
+    const std::vector<dd::fp> tolerances{1e-13, 1e-12, 1e-10, 1e-8};
+    constexpr std::size_t     ntasks = 16U;
+
+    auto runCheck = [&](std::size_t task) {
+        qc::QuantumComputation qc1{};
+        qc::QuantumComputation qc2{};
+        qc1.import("./circuits/test/test_original.real");
+        qc2.import(task % 2U == 0U ? "./circuits/test/test_alternative.real" : "./circuits/test/test_erroneous.real");
+
+        ec::Configuration config{};
+        config.tolerance       = tolerances.at(task % tolerances.size());
+        config.computeFidelity = true;
+        ec::ImprovedDDEquivalenceChecker ec(qc1, qc2);
+        return ec.check(config);
+    };
+
+    std::vector<ec::EquivalenceCheckingResults> sequential(ntasks);
+    for (std::size_t i = 0; i < ntasks; ++i) {
+        sequential[i] = runCheck(i);
+    }
+
+    std::vector<ec::EquivalenceCheckingResults> concurrent(ntasks);
+    std::atomic<std::size_t>                    next{0U};
+    std::vector<std::thread>                    pool{};
+    for (std::size_t t = 0; t < 4U; ++t) {
+        pool.emplace_back([&]() {
+            for (auto i = next++; i < ntasks; i = next++) {
+                concurrent[i] = runCheck(i);
+            }
+        });
+    }
+    for (auto& worker: pool) {
+        worker.join();
+    }
+
+    for (std::size_t i = 0; i < ntasks; ++i) {
+        EXPECT_EQ(concurrent[i].equivalence, sequential[i].equivalence);
+        EXPECT_TRUE(concurrent[i].traceComputed);
+        EXPECT_DOUBLE_EQ(concurrent[i].processFidelity, sequential[i].processFidelity);
+        if (i % 2U == 0U) {
+            EXPECT_TRUE(concurrent[i].consideredEquivalent());
+            EXPECT_NEAR(concurrent[i].processFidelity, 1., 1e-6);
+        } else {
+            EXPECT_FALSE(concurrent[i].consideredEquivalent());
+        }
+    }
+}
+
+TEST_F(GeneralTest, DefaultTolerance) {
+    // a check with a different tolerance does not change the default of later configurations
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    ec::Configuration config{};
+    config.tolerance = 1e-8;
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    ec.check(config);
+    EXPECT_EQ(ec::Configuration{}.tolerance, ec::Configuration::DEFAULT_TOLERANCE);
+    EXPECT_EQ(ec::Configuration{}.tolerance, 1e-13);
+}
+
+TEST_F(GeneralTest, HeuristicAbort) {
+    qc_original.addQubitRegister(2);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::H);
+
+    qc_alternative.addQubitRegister(2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::Z);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::H);
+
+    ec::Configuration config{};
+    config.strategy                 = ec::Strategy::Naive;
+    config.fuseSingleQubitGates     = false;
+    config.heuristicAbortInterval  = 1;
+    config.heuristicAbortThreshold = 0.5;
+
+    // tr(X) = 0, hence the first sample already falls below the threshold
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::NoInformation);
+    EXPECT_TRUE(results.heuristicallyAborted);
+    EXPECT_EQ(results.abortGateIndex, 1U);
+    EXPECT_EQ(results.abortGates1, 1U);
+    EXPECT_EQ(results.abortGates2, 0U);
+    EXPECT_NEAR(results.abortFidelity, 0., 1e-10);
+    results.printJSON();
+
+    config.heuristicAbortInterval = 0;
+    ec::ImprovedDDEquivalenceChecker ec2(qc_original, qc_alternative);
+    results = ec2.check(config);
+    EXPECT_FALSE(results.heuristicallyAborted);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::NotEquivalent);
+}
+
+TEST_F(GeneralTest, HeuristicAbortEquivalentCircuits) {
+    qc_original.addQubitRegister(3);
+    qc_original.emplace_back<qc::StandardOperation>(3, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(3, 1, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(3, dd::Control{1}, 2, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(3, 2, qc::RY, 0.3);
+
+    qc_alternative.addQubitRegister(3);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, 1, qc::T);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, dd::Control{1}, 2, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, 2, qc::RY, 0.3);
+
+    ec::Configuration config{};
+    config.strategy                = ec::Strategy::Naive;
+    config.fuseSingleQubitGates    = false;
+    config.heuristicAbortInterval  = 2;
+    config.heuristicAbortThreshold = 0.9;
+
+    // the naive strategy alternates between both circuits, so every sample is taken after matching prefixes of both circuits
+    // and the intermediate result of these equivalent circuits is the identity
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    EXPECT_FALSE(results.heuristicallyAborted);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+}
+
+TEST_F(GeneralTest, GateCache) {
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+
+    ec::Configuration config{};
+    config.fuseSingleQubitGates = false;
+    config.reconstructSWAPs     = false;
+    config.cacheGateDDs         = true;
+
+    // every gate is built once and then reused for all further stimuli
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_GT(results.gateCacheMisses, 0U);
+    EXPECT_EQ(results.gateCacheHits, (results.nsims - 1U) * results.gateCacheMisses);
+
+    // the cache survives between checks on the same instance
+    auto results2 = ec.check(config);
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results2.gateCacheMisses, 0U);
+    EXPECT_GT(results2.gateCacheHits, 0U);
+
+    config.cacheGateDDs = false;
+    ec::SimulationBasedEquivalenceChecker ec2(qc_original, qc_alternative, 12345);
+    auto                                  results3 = ec2.check(config);
+    EXPECT_EQ(results3.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results3.gateCacheHits, 0U);
+    EXPECT_EQ(results3.gateCacheMisses, 0U);
+}
+
+TEST_F(GeneralTest, MiterCancellation) {
+    qc_original.addQubitRegister(2);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::RZ, 0.3);
+
+    qc_alternative.addQubitRegister(2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::RZ, 0.1);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::RZ, 0.2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::T);
+
+    ec::Configuration config{};
+    config.cancelMiterGates = true;
+
+    // the T gates commute with the rotations and the rotations merge into the identity, so the whole miter cancels
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_TRUE(results.miterCancelled);
+    EXPECT_EQ(results.miterRemovedGates1, 4U);
+    EXPECT_EQ(results.miterRemovedGates2, 5U);
+    EXPECT_EQ(results.miterMergedRotations, 2U);
+    EXPECT_EQ(qc_original.getNops(), 0U);
+    EXPECT_EQ(qc_alternative.getNops(), 0U);
+
+    // the result of the check is preserved
+    for (const auto* file: {"./circuits/test/test_alternative.real", "./circuits/test/test_erroneous.real"}) {
+        qc::QuantumComputation original("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative(file);
+        qc::QuantumComputation original2("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative2(file);
+
+        ec::ImprovedDDEquivalenceChecker reference(original, alternative);
+        ec::ImprovedDDEquivalenceChecker cancelled(original2, alternative2);
+        EXPECT_EQ(cancelled.check(config).equivalence, reference.check().equivalence);
+    }
+}
+
+TEST_F(GeneralTest, CommonGateStripping) {
+    qc_original.addQubitRegister(2);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::RZ, 0.2);
+
+    qc_alternative.addQubitRegister(2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::RZ, 0.2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::S);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::H);
+
+    ec::Configuration config{};
+    config.fuseSingleQubitGates = false;
+    config.stripCommonGates     = true;
+
+    // the rotation commutes with the control of the CNOT, so only T T and S remain
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_TRUE(results.commonGatesStripped);
+    EXPECT_EQ(results.strippedPrefix, 3U);
+    EXPECT_EQ(results.strippedSuffix, 1U);
+    EXPECT_EQ(results.remainingGates1, 2U);
+    EXPECT_EQ(results.remainingGates2, 1U);
+
+    // the result of the check is preserved
+    for (const auto* file: {"./circuits/test/test_alternative.real", "./circuits/test/test_erroneous.real"}) {
+        qc::QuantumComputation original("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative(file);
+        qc::QuantumComputation original2("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative2(file);
+
+        ec::ImprovedDDEquivalenceChecker reference(original, alternative);
+        ec::ImprovedDDEquivalenceChecker stripped(original2, alternative2);
+        EXPECT_EQ(stripped.check(config).equivalence, reference.check().equivalence);
+    }
+}
+
+TEST_F(GeneralTest, GarbageCollectionInterval) {
+    qc_original.addQubitRegister(2);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+
+    qc_alternative.addQubitRegister(2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::S);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::I);
+
+    ec::Configuration config{};
+    config.fuseSingleQubitGates    = false;
+    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::Interval;
+    config.gcInterval              = 2;
+
+    // a collection after every second of the eight applied gates
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results.gcCollections, 4U);
+    EXPECT_GT(results.gcPeakNodes, 0U);
+}
+
+TEST_F(GeneralTest, GarbageCollectionMemoryBudgetBackoff) {
+    qc_original.addQubitRegister(2);
+    qc_original.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(2, 1, qc::T);
+
+    qc_alternative.addQubitRegister(2);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 1, qc::S);
+    qc_alternative.emplace_back<qc::StandardOperation>(2, 0, qc::I);
+
+    ec::Configuration config{};
+    config.fuseSingleQubitGates    = false;
+    config.garbageCollectionPolicy = ec::GarbageCollectionPolicy::MemoryBudget;
+    config.gcMemoryBudget          = 0;
+
+    // the budget is always exceeded, so collections back off after gates 1, 2, 4, and 8 instead of collecting after every gate
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results.gcCollections, 4U);
+}
+
+TEST_F(GeneralTest, ResourceLimits) {
+    qc_original.addQubitRegister(3);
+    qc_original.emplace_back<qc::StandardOperation>(3, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(3, dd::Control{1}, 2, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(3, 2, qc::T);
+
+    qc_alternative.addQubitRegister(3);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, dd::Control{1}, 2, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(3, 2, qc::T);
+
+    ec::Configuration config{};
+    config.fuseSingleQubitGates = false;
+    config.maxActiveNodes       = 1;
+
+    // the identity alone already occupies more than a single node
+    ec::ImprovedDDEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::NoInformation);
+    EXPECT_TRUE(results.limitExceeded);
+    EXPECT_EQ(results.limitReason, "active nodes");
+    EXPECT_GT(results.limitGates1 + results.limitGates2, 0U);
+    EXPECT_LE(results.limitGates1, qc_original.getNops());
+    EXPECT_LE(results.limitGates2, qc_alternative.getNops());
+
+    // without the limit, the check succeeds
+    config.maxActiveNodes = 0;
+    ec::ImprovedDDEquivalenceChecker unlimited(qc_original, qc_alternative);
+    results = unlimited.check(config);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+    EXPECT_FALSE(results.limitExceeded);
+}
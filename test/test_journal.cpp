@@ -5,13 +5,16 @@
 
 #include "ImprovedDDEquivalenceChecker.hpp"
 #include "SimulationBasedEquivalenceChecker.hpp"
+#include "TraceEngine.hpp"
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <iostream>
 #include <random>
+#include <thread>
 #include <string>
 
 class JournalTestNonEQ: public testing::TestWithParam<std::tuple<std::string, unsigned short>> {
@@ -171,6 +174,40 @@ TEST_P(JournalTestNonEQ, PowerOfSimulation) {
               << (double)successes / (double)tries << ";" << std::endl;
 }
 
+TEST_P(JournalTestNonEQ, GuidedStimuli) {
+    // compare the transpiled circuit to itself with some gates removed (as in sim_app --remove). The removed gates and the
+    // stimuli are seeded, so the reported numbers are reproducible. Whether guidance pays off depends on the circuit and is only
+    // reported, not asserted.
+    std::mt19937_64           removal(42U);
+    std::array<std::size_t, 2> total{};
+    for (unsigned short i = 0; i < tries; ++i) {
+        qc_transpiled.import(transpiled_file);
+        std::set<unsigned long long> removed{};
+        while (removed.size() < gates_to_remove) {
+            removed.insert(removal() % qc_transpiled.getNops());
+        }
+
+        std::array<std::size_t, 2> nsims{};
+        for (const bool guided: {false, true}) {
+            qc::QuantumComputation qc_reference(transpiled_file);
+            qc::QuantumComputation qc_modified(transpiled_file);
+            for (auto it = removed.rbegin(); it != removed.rend(); ++it) {
+                qc_modified.erase(std::next(qc_modified.begin(), static_cast<std::ptrdiff_t>(*it)));
+            }
+
+            config.differenceGuidedStimuli = guided;
+            ec::SimulationBasedEquivalenceChecker noneq_sim(qc_reference, qc_modified, 12345U + i);
+            auto                                  results = noneq_sim.check(config);
+            nsims[guided]                                 = results.nsims;
+            EXPECT_GT(results.nsims, 0U);
+        }
+        std::cout << "[" << i << "] " << nsims[0] << " vs. " << nsims[1] << " (guided) simulations" << std::endl;
+        total[0] += nsims[0];
+        total[1] += nsims[1];
+    }
+    std::cout << qc_transpiled.getName() << ";" << gates_to_remove << ";" << tries << ";" << total[0] << ";" << total[1] << ";" << std::endl;
+}
+
 class JournalTestEQ: public testing::TestWithParam<std::string> {
 protected:
     qc::QuantumComputation qc_original;
@@ -271,6 +308,72 @@ TEST_P(JournalTestEQ, EQLookahead) {
     EXPECT_TRUE(results.consideredEquivalent());
 }
 
+TEST_P(JournalTestEQ, EQBeamLookahead) {
+    qc_original.import(test_original_dir + GetParam() + ".real");
+    qc_transpiled.import(transpiled_file);
+
+    ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+    config.strategy = ec::Strategy::BeamLookahead;
+    auto results    = equivalenceChecker.check(config);
+    results.printCSVEntry();
+    results.print();
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_P(JournalTestEQ, EQSizeFeedback) {
+    qc_original.import(test_original_dir + GetParam() + ".real");
+    qc_transpiled.import(transpiled_file);
+
+    ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+    config.strategy = ec::Strategy::SizeFeedback;
+    auto results    = equivalenceChecker.check(config);
+    results.printCSVEntry();
+    results.print();
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_P(JournalTestEQ, EQCommutation) {
+    qc_original.import(test_original_dir + GetParam() + ".real");
+    qc_transpiled.import(transpiled_file);
+
+    ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+    config.strategy = ec::Strategy::Commutation;
+    auto results    = equivalenceChecker.check(config);
+    results.printCSVEntry();
+    results.print();
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_P(JournalTestEQ, StrategyBenchmark) {
+    std::cout << GetParam() << std::endl;
+    for (const auto strategy: {ec::Strategy::Proportional, ec::Strategy::Lookahead, ec::Strategy::BeamLookahead, ec::Strategy::SizeFeedback, ec::Strategy::Commutation}) {
+        qc_original.import(test_original_dir + GetParam() + ".real");
+        qc_transpiled.import(transpiled_file);
+
+        ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+        config.strategy = strategy;
+        auto results    = equivalenceChecker.check(config);
+        std::cout << "  " << ec::toString(strategy) << ": " << results.verificationTime << "s, " << results.maxActive << " max. active nodes" << std::endl;
+        EXPECT_TRUE(results.consideredEquivalent());
+    }
+}
+
+TEST_P(JournalTestEQ, GarbageCollectionBenchmark) {
+    std::cout << GetParam() << std::endl;
+    for (const auto policy: {ec::GarbageCollectionPolicy::PerGate, ec::GarbageCollectionPolicy::NodeThreshold, ec::GarbageCollectionPolicy::MemoryBudget, ec::GarbageCollectionPolicy::Interval}) {
+        qc_original.import(test_original_dir + GetParam() + ".real");
+        qc_transpiled.import(transpiled_file);
+
+        ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+        config.garbageCollectionPolicy = policy;
+        config.gcNodeThreshold         = 1U << 16U;
+        config.gcMemoryBudget          = std::size_t{1} << 24U;
+        auto results                   = equivalenceChecker.check(config);
+        std::cout << "  " << ec::toString(policy) << ": " << results.verificationTime << "s, " << results.gcCollections << " collections (" << results.gcTime << "s), " << results.gcPeakNodes << " peak nodes" << std::endl;
+        EXPECT_TRUE(results.consideredEquivalent());
+    }
+}
+
 TEST_P(JournalTestEQ, EQPowerOfSimulation) {
     qc_original.import(test_original_dir + GetParam() + ".real");
     qc_transpiled.import(transpiled_file);
@@ -281,3 +384,30 @@ TEST_P(JournalTestEQ, EQPowerOfSimulation) {
     results.print();
     EXPECT_TRUE(results.consideredEquivalent());
 }
+
+TEST_P(JournalTestEQ, TraceRecursiveVsParallel) {
+    qc_original.import(test_original_dir + GetParam() + ".real");
+    qc_transpiled.import(transpiled_file);
+
+    // remove a gate from the middle of the compiled circuit so that the resulting DD is far from the identity
+    auto it = qc_transpiled.begin();
+    std::advance(it, qc_transpiled.getNops() / 2);
+    qc_transpiled.erase(it);
+
+    ec::ImprovedDDEquivalenceChecker equivalenceChecker(qc_original, qc_transpiled);
+    auto                             results = equivalenceChecker.check(config);
+    EXPECT_FALSE(results.consideredEquivalent());
+
+    ec::TraceEngine               engine{};
+    auto                          start         = std::chrono::steady_clock::now();
+    auto                          recursive     = engine.trace(results.result, results.nqubits);
+    auto                          endRecursive  = std::chrono::steady_clock::now();
+    auto                          parallel      = engine.traceParallel(results.result, results.nqubits, std::max(2U, std::thread::hardware_concurrency()));
+    auto                          endParallel   = std::chrono::steady_clock::now();
+    std::chrono::duration<double> recursiveTime = endRecursive - start;
+    std::chrono::duration<double> parallelTime  = endParallel - endRecursive;
+
+    std::cout << GetParam() << ";" << engine.size() << ";" << recursiveTime.count() << ";" << parallelTime.count() << std::endl;
+    EXPECT_NEAR(recursive.real(), parallel.real(), 1e-8);
+    EXPECT_NEAR(recursive.imag(), parallel.imag(), 1e-8);
+}
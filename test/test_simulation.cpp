@@ -3,9 +3,18 @@
  * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
  */
 
+#include "Approximation.hpp"
+#include "CrossPackage.hpp"
+#include "DenseState.hpp"
+#include "SimulationCache.hpp"
 #include "SimulationBasedEquivalenceChecker.hpp"
+#include "StimulusPermutation.hpp"
 
 #include "gtest/gtest.h"
+#include <filesystem>
+#include <random>
+#include <set>
+#include <sstream>
 
 class SimulationTest: public ::testing::Test {
 protected:
@@ -126,3 +135,549 @@ TEST_F(SimulationTest, PlusState) {
     results2.printJSON();
     EXPECT_FALSE(results2.consideredEquivalent());
 }
+
+TEST_F(SimulationTest, FidelityEstimation) {
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    config.stimuliType      = ec::StimuliType::GlobalQuantum;
+    config.estimateFidelity = true;
+    config.max_sims         = 64;
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    results.printJSON();
+    EXPECT_TRUE(results.fidelityEstimated);
+    EXPECT_TRUE(results.consideredEquivalent());
+    EXPECT_NEAR(results.fidelityEstimate, 1., 1e-8);
+    EXPECT_LE(results.ciLow, results.fidelityEstimate);
+    EXPECT_GE(results.ciHigh, results.fidelityEstimate);
+    EXPECT_GE(results.nsims, config.fidelityMinSims);
+    // all samples agree, but a finite number of them cannot pin down the fidelity
+    EXPECT_LT(results.ciLow, 1.);
+    EXPECT_EQ(results.nsims, config.max_sims);
+
+    qc_alternative.import("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker ec2(qc_original, qc_alternative, 12345);
+    auto                                  results2 = ec2.check(config);
+    results2.print();
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_LT(results2.fidelityEstimate, 1.);
+    EXPECT_LE(results2.ciLow, results2.fidelityEstimate);
+    EXPECT_GE(results2.ciHigh, results2.fidelityEstimate);
+    EXPECT_LE(results2.nsims, config.max_sims);
+}
+
+TEST_F(SimulationTest, ParallelSimulation) {
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    config.nthreads = 4;
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    results.printJSON();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::Equivalent);
+
+    // every completed simulation is counted exactly once
+    qc::QuantumComputation original("./circuits/test/test_original.real");
+    qc::QuantumComputation alternative("./circuits/test/test_alternative.real");
+    auto                   global = config;
+    global.stimuliType            = ec::StimuliType::GlobalQuantum;
+    ec::SimulationBasedEquivalenceChecker ec3(original, alternative, 12345);
+    auto                                  results3 = ec3.check(global);
+    EXPECT_TRUE(results3.consideredEquivalent());
+    EXPECT_EQ(results3.nsims, global.max_sims);
+
+    qc_alternative.import("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker ec2(qc_original, qc_alternative, 12345);
+    auto                                  results2 = ec2.check(config);
+    results2.print();
+    results2.printJSON();
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_GE(results2.nsims, 1U);
+    EXPECT_LE(results2.nsims, config.max_sims);
+    EXPECT_FALSE(results2.cexInput.empty());
+    EXPECT_FALSE(results2.circuit1.cexOutput.empty());
+    EXPECT_FALSE(results2.circuit2.cexOutput.empty());
+}
+
+TEST_F(SimulationTest, ConcurrentCircuitSimulation) {
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    config.stimuliType                 = ec::StimuliType::GlobalQuantum;
+    config.concurrentCircuitSimulation = true;
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    results.printJSON();
+    EXPECT_TRUE(results.consideredEquivalent());
+    EXPECT_EQ(results.nsims, config.max_sims);
+
+    qc_alternative.import("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker ec2(qc_original, qc_alternative, 12345);
+    auto                                  results2 = ec2.check(config);
+    results2.print();
+    results2.printJSON();
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_FALSE(results2.circuit1.cexOutput.empty());
+    EXPECT_FALSE(results2.circuit2.cexOutput.empty());
+
+    // the fidelity computed across packages agrees with the one computed in a single package
+    config.concurrentCircuitSimulation = false;
+    ec::SimulationBasedEquivalenceChecker ec3(qc_original, qc_alternative, 12345);
+    auto                                  results3 = ec3.check(config);
+    EXPECT_EQ(results3.nsims, results2.nsims);
+    EXPECT_NEAR(results3.fidelity, results2.fidelity, 1e-8);
+}
+
+TEST_F(SimulationTest, CrossPackageInnerProduct) {
+    auto dd1 = std::make_unique<dd::Package>(3);
+    auto dd2 = std::make_unique<dd::Package>(3);
+
+    auto x = dd1->makeBasisState(3, {dd::BasisStates::plus, dd::BasisStates::one, dd::BasisStates::right});
+    auto y = dd1->makeBasisState(3, {dd::BasisStates::zero, dd::BasisStates::one, dd::BasisStates::left});
+    dd1->incRef(x);
+    dd1->incRef(y);
+
+    auto x2 = ec::transfer(x, dd2);
+    auto y2 = ec::transfer(y, dd2);
+    EXPECT_EQ(dd2->getVector(x2), dd1->getVector(x));
+
+    const auto expected = dd1->innerProduct(x, y);
+    const auto actual   = ec::innerProduct(x, y2);
+    EXPECT_NEAR(actual.real(), expected.r, 1e-10);
+    EXPECT_NEAR(actual.imag(), expected.i, 1e-10);
+    EXPECT_NEAR(ec::fidelity(x2, y), dd1->fidelity(x, y), 1e-10);
+    EXPECT_NEAR(ec::fidelity(x, x2), 1., 1e-10);
+}
+
+TEST_F(SimulationTest, StimulusPermutation) {
+    // small instances are enumerated exhaustively without repetition
+    for (std::size_t n = 1U; n <= 10U; ++n) {
+        ec::StimulusPermutation     permutation(n, 12345U + n);
+        std::set<std::vector<bool>>       images{};
+        for (std::uint64_t i = 0U; i < permutation.size(); ++i) {
+            auto image = permutation(i);
+            EXPECT_EQ(image.size(), n);
+            images.insert(image);
+        }
+        EXPECT_EQ(images.size(), permutation.size());
+    }
+
+    // arbitrary qubit counts are supported
+    for (const std::size_t n: {63U, 64U, 65U, 127U, 300U}) {
+        ec::StimulusPermutation     permutation(n, 42U);
+        std::set<std::vector<bool>> images{};
+        for (std::uint64_t i = 0U; i < 1024U; ++i) {
+            images.insert(permutation(i));
+        }
+        EXPECT_EQ(images.size(), 1024U);
+    }
+}
+
+TEST_F(SimulationTest, ClassicalStimuliManyQubits) {
+    const dd::QubitCount nqubits = 80;
+    qc_original.addQubitRegister(nqubits);
+    qc_alternative.addQubitRegister(nqubits);
+    for (dd::Qubit i = 0; i < static_cast<dd::Qubit>(nqubits - 1); ++i) {
+        qc_original.emplace_back<qc::StandardOperation>(nqubits, dd::Control{i}, static_cast<dd::Qubit>(i + 1), qc::X);
+        qc_alternative.emplace_back<qc::StandardOperation>(nqubits, dd::Control{i}, static_cast<dd::Qubit>(i + 1), qc::X);
+    }
+    // flip the last qubit of the alternative circuit only
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, static_cast<dd::Qubit>(nqubits - 1), qc::X);
+
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    EXPECT_EQ(results.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_EQ(results.nsims, 1U);
+}
+
+TEST_F(SimulationTest, ReferenceVersusCandidates) {
+    qc::QuantumComputation reference("./circuits/test/test_original.real");
+    qc::QuantumComputation alternative("./circuits/test/test_alternative.real");
+    qc::QuantumComputation erroneous("./circuits/test/test_erroneous.real");
+    qc::QuantumComputation original("./circuits/test/test_original.real");
+
+    auto results = ec::SimulationBasedEquivalenceChecker::checkCandidates(reference, {alternative, erroneous, original}, config, 12345);
+    ASSERT_EQ(results.size(), 3U);
+    for (const auto& result: results) {
+        result.print();
+    }
+    EXPECT_EQ(results[0].equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results[1].equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_FALSE(results[1].cexInput.empty());
+    EXPECT_EQ(results[2].equivalence, ec::Equivalence::Equivalent);
+
+    // the same verdicts are reached by checking every pair individually
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    EXPECT_EQ(ec.check(config).equivalence, results[1].equivalence);
+}
+
+TEST_F(SimulationTest, ReferenceVersusIdenticalCandidates) {
+    // the passes on the shared reference must run only once
+    config.reconstructSWAPs                 = true;
+    config.fuseSingleQubitGates             = true;
+    config.removeDiagonalGatesBeforeMeasure = true;
+    qc::QuantumComputation reference("./circuits/test/test_original.real");
+    qc::QuantumComputation first("./circuits/test/test_original.real");
+    qc::QuantumComputation second("./circuits/test/test_original.real");
+    auto                   results = ec::SimulationBasedEquivalenceChecker::checkCandidates(reference, {first, second}, config, 12345);
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0].equivalence, ec::Equivalence::Equivalent);
+    EXPECT_EQ(results[1].equivalence, ec::Equivalence::Equivalent);
+
+    // stripping common gates would rewrite the reference for every candidate
+    config.stripCommonGates = true;
+    qc::QuantumComputation reference2("./circuits/test/test_original.real");
+    qc::QuantumComputation third("./circuits/test/test_original.real");
+    qc::QuantumComputation fourth("./circuits/test/test_original.real");
+    EXPECT_THROW(ec::SimulationBasedEquivalenceChecker::checkCandidates(reference2, {third, fourth}, config, 12345), std::invalid_argument);
+    config.stripCommonGates = false;
+
+    // options the batched check cannot honor are rejected as well
+    config.differenceGuidedStimuli = true;
+    EXPECT_THROW(ec::SimulationBasedEquivalenceChecker::checkCandidates(reference2, {third, fourth}, config, 12345), std::invalid_argument);
+    config.differenceGuidedStimuli = false;
+    config.nthreads                = 2;
+    EXPECT_THROW(ec::SimulationBasedEquivalenceChecker::checkCandidates(reference2, {third, fourth}, config, 12345), std::invalid_argument);
+}
+
+TEST_F(SimulationTest, PersistentSimulationCache) {
+    // a directory of its own, so that concurrent runs of the test do not delete each other's entries
+    std::mt19937_64 rng(std::random_device{}() ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    auto            directory = std::filesystem::temp_directory_path() / ("qcec_simulation_cache_test_" + std::to_string(rng()));
+    while (std::filesystem::exists(directory)) {
+        directory = std::filesystem::temp_directory_path() / ("qcec_simulation_cache_test_" + std::to_string(rng()));
+    }
+    config.simulationCacheDirectory = directory.string();
+
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker first(qc_original, qc_alternative, 12345);
+    auto                                  cold = first.check(config);
+    cold.print();
+    EXPECT_TRUE(cold.consideredEquivalent());
+    EXPECT_EQ(cold.simulationCacheHits, 0U);
+    EXPECT_EQ(cold.simulationCacheMisses, cold.nsims);
+
+    // a later run with the same seed loads all outputs of the unchanged circuit from disk
+    qc::QuantumComputation original("./circuits/test/test_original.real");
+    qc::QuantumComputation alternative("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker second(original, alternative, 12345);
+    auto                                  warm = second.check(config);
+    warm.print();
+    EXPECT_EQ(warm.equivalence, cold.equivalence);
+    EXPECT_EQ(warm.simulationCacheHits, warm.nsims);
+    EXPECT_EQ(warm.simulationCacheMisses, 0U);
+
+    // a different tolerance invalidates the entries
+    config.tolerance = 1e-12;
+    qc::QuantumComputation original2("./circuits/test/test_original.real");
+    qc::QuantumComputation alternative2("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker third(original2, alternative2, 12345);
+    EXPECT_EQ(third.check(config).simulationCacheHits, 0U);
+
+    // the cache never exceeds its size bound
+    config.simulationCacheSize = 0U;
+    qc::QuantumComputation original3("./circuits/test/test_original.real");
+    qc::QuantumComputation alternative3("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker fourth(original3, alternative3, 12345);
+    fourth.check(config);
+    EXPECT_EQ(ec::SimulationCache(directory, 0U).size(), 0U);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(SimulationTest, SimulationCacheSerialization) {
+    auto dd = std::make_unique<dd::Package>(3);
+    auto e  = dd->makeBasisState(3, {dd::BasisStates::plus, dd::BasisStates::one, dd::BasisStates::right});
+
+    std::stringstream ss{};
+    ec::SimulationCache::serialize(e, ss);
+    auto f = ec::SimulationCache::deserialize(ss, dd);
+    EXPECT_EQ(f.p, e.p);
+    EXPECT_TRUE(f.w.approximatelyEquals(e.w));
+    EXPECT_EQ(ec::SimulationCache::hash(e), ec::SimulationCache::hash(f));
+    EXPECT_NE(ec::SimulationCache::hash(e), ec::SimulationCache::hash(dd->makeZeroState(3)));
+}
+
+TEST_F(SimulationTest, AdaptiveStimuli) {
+    config.adaptiveStimuli = true;
+    config.max_sims        = 256;
+
+    qc_original.import("./circuits/test/test_original.real");
+    qc_alternative.import("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    EXPECT_TRUE(results.consideredEquivalent());
+    EXPECT_GE(results.equivalenceConfidence, config.equivalenceConfidence);
+    // the check stops long before the simulation budget is exhausted
+    EXPECT_LT(results.nsims, config.max_sims);
+    for (const auto n: results.simsPerStimuliType) {
+        EXPECT_GE(n, 1U);
+    }
+    EXPECT_TRUE(results.produceJSON()["statistics"].contains("assumed_confidence"));
+    EXPECT_NE(results.produceCSVEntry().find(";" + std::to_string(results.nsims) + ";"), std::string::npos);
+
+    qc::QuantumComputation original("./circuits/test/test_original.real");
+    qc::QuantumComputation erroneous("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker ec2(original, erroneous, 12345);
+    auto                                  results2 = ec2.check(config);
+    results2.print();
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_EQ(results2.equivalenceConfidence, 0.);
+
+    config.maxActiveNodes = 1;
+    qc::QuantumComputation                original2("./circuits/test/test_original.real");
+    qc::QuantumComputation                alternative("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker ec3(original2, alternative, 12345);
+    auto                                  results3 = ec3.check(config);
+    EXPECT_EQ(results3.equivalence, ec::Equivalence::NoInformation);
+    EXPECT_TRUE(results3.limitExceeded);
+    EXPECT_EQ(results3.equivalenceConfidence, 0.);
+}
+
+TEST_F(SimulationTest, ApproximateSimulation) {
+    // entangled state with amplitudes of widely differing magnitudes
+    const dd::QubitCount nqubits = 8;
+    const auto           build   = [&](qc::QuantumComputation& circ) {
+        circ.addQubitRegister(nqubits);
+        for (dd::Qubit i = 0; i < static_cast<dd::Qubit>(nqubits); ++i) {
+            circ.emplace_back<qc::StandardOperation>(nqubits, i, qc::RY, 0.2 * (i + 1));
+        }
+        for (dd::Qubit i = 0; i < static_cast<dd::Qubit>(nqubits - 1); ++i) {
+            circ.emplace_back<qc::StandardOperation>(nqubits, dd::Control{i}, static_cast<dd::Qubit>(i + 1), qc::RZ, 0.3 * (i + 1));
+        }
+    };
+    qc::QuantumComputation circ{};
+    build(circ);
+    auto       dd    = std::make_unique<dd::Package>(nqubits);
+    const auto exact = circ.simulate(dd->makeZeroState(nqubits), dd);
+    dd->incRef(exact);
+
+    dd::fp     fidelity     = 0.;
+    const auto approximated = ec::approximate(exact, dd->size(exact) / 2U, dd, fidelity);
+    EXPECT_LT(dd->size(approximated), dd->size(exact));
+    EXPECT_LT(fidelity, 1.);
+    EXPECT_NEAR(dd->innerProduct(approximated, approximated).r, 1., 1e-8);
+    EXPECT_NEAR(dd->fidelity(exact, approximated), fidelity, 1e-8);
+
+    // the budget is met even if it requires keeping a single basis state
+    for (const std::size_t budget: {static_cast<std::size_t>(nqubits), std::size_t{3}}) {
+        dd::fp     f      = 0.;
+        const auto pruned = ec::approximate(exact, budget, dd, f);
+        EXPECT_LE(dd->size(pruned), std::max(budget, static_cast<std::size_t>(nqubits) + 1U));
+        EXPECT_GT(f, 0.);
+        EXPECT_NEAR(dd->innerProduct(pruned, pruned).r, 1., 1e-8);
+    }
+
+    // the bounds enclose the fidelity of the exact states
+    EXPECT_LE(ec::fidelityLowerBound(0.9, 0.1), 0.9);
+    EXPECT_GE(ec::fidelityUpperBound(0.9, 0.1), 0.9);
+    EXPECT_EQ(ec::fidelityLowerBound(0.9, 10.), 0.);
+    EXPECT_EQ(ec::fidelityUpperBound(0.9, 10.), 1.);
+
+    // an approximate check never shows equivalent circuits to be non-equivalent
+    config.approximationNodeBudget = dd->size(exact) / 2U;
+    config.fidelity_limit          = 0.5;
+    config.stimuliType             = ec::StimuliType::LocalQuantum;
+    build(qc_original);
+    build(qc_alternative);
+    ec::SimulationBasedEquivalenceChecker ec(qc_original, qc_alternative, 12345);
+    auto                                  results = ec.check(config);
+    results.print();
+    EXPECT_NE(results.equivalence, ec::Equivalence::NotEquivalent);
+    EXPECT_TRUE(results.approximated);
+    EXPECT_GT(results.approximations, 0U);
+    EXPECT_LE(results.fidelityLowerBound, results.fidelity);
+    EXPECT_GE(results.fidelityUpperBound, results.fidelity);
+    EXPECT_GT(results.approximationPeakNodes, config.approximationNodeBudget);
+    EXPECT_TRUE(results.produceJSON()["statistics"].contains("approximation"));
+
+    // pruned states of circuits with garbage outputs yield no guaranteed bounds
+    qc::QuantumComputation original{};
+    qc::QuantumComputation alternative{};
+    build(original);
+    build(alternative);
+    original.setLogicalQubitGarbage(0);
+    alternative.setLogicalQubitGarbage(0);
+    ec::SimulationBasedEquivalenceChecker ec2(original, alternative, 12345);
+    auto                                  results2 = ec2.check(config);
+    EXPECT_TRUE(results2.approximated);
+    EXPECT_GT(results2.approximations, 0U);
+    EXPECT_EQ(results2.equivalence, ec::Equivalence::NoInformation);
+    EXPECT_EQ(results2.fidelityLowerBound, 0.);
+    EXPECT_EQ(results2.fidelityUpperBound, 1.);
+}
+
+TEST_F(SimulationTest, DenseState) {
+    const dd::QubitCount   nqubits = 4;
+    qc::QuantumComputation circ(nqubits);
+    circ.emplace_back<qc::StandardOperation>(nqubits, 0, qc::H);
+    circ.emplace_back<qc::StandardOperation>(nqubits, 3, qc::U3, 0.3, 0.2, 0.1);
+    circ.emplace_back<qc::StandardOperation>(nqubits, dd::Control{0}, 2, qc::RY, 0.7);
+    circ.emplace_back<qc::StandardOperation>(nqubits, dd::Controls{dd::Control{1, dd::Control::Type::neg}}, 0, 3, qc::iSWAP);
+    circ.emplace_back<qc::StandardOperation>(nqubits, dd::Controls{dd::Control{2}}, 1, 3, qc::SWAP);
+    circ.emplace_back<qc::StandardOperation>(nqubits, dd::Controls{}, 0, 2, qc::SWAP);
+    circ.emplace_back<qc::StandardOperation>(nqubits, dd::Control{3}, 1, qc::Phase, 0.4);
+    circ.emplace_back<qc::StandardOperation>(nqubits, 2, qc::SX);
+
+    auto       dd       = std::make_unique<dd::Package>(nqubits);
+    auto       stimulus = dd->makeBasisState(nqubits, {dd::BasisStates::plus, dd::BasisStates::one, dd::BasisStates::right, dd::BasisStates::zero});
+    const auto expected = dd->getVector(circ.simulate(stimulus, dd));
+
+    auto            state       = ec::DenseState::fromVectorDD(stimulus, nqubits);
+    qc::Permutation permutation = circ.initialLayout;
+    for (const auto& op: circ) {
+        state.apply(*op, permutation);
+    }
+    state.changePermutation(permutation, circ.outputPermutation);
+    const auto actual = state.getVector();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0U; i < actual.size(); ++i) {
+        EXPECT_NEAR(std::get<0>(actual[i]), std::get<0>(expected[i]), 1e-10);
+        EXPECT_NEAR(std::get<1>(actual[i]), std::get<1>(expected[i]), 1e-10);
+    }
+    EXPECT_NEAR(state.fidelity(ec::DenseState::fromVectorDD(state.toVectorDD(dd), nqubits)), 1., 1e-10);
+
+    // the matrices computed up front (for all operations but the uncontrolled SWAP) lead to the same state
+    ec::DenseState::MatrixCache matrices{};
+    for (const auto& op: circ) {
+        ec::DenseState::addGateMatrices(*op, matrices);
+    }
+    EXPECT_EQ(matrices.size(), circ.getNops() - 1U);
+    auto            cached            = ec::DenseState::fromVectorDD(stimulus, nqubits);
+    qc::Permutation cachedPermutation = circ.initialLayout;
+    for (const auto& op: circ) {
+        cached.apply(*op, cachedPermutation, &matrices);
+    }
+    cached.changePermutation(cachedPermutation, circ.outputPermutation);
+    EXPECT_NEAR(cached.fidelity(state), 1., 1e-10);
+}
+
+TEST_F(SimulationTest, DenseStateThreads) {
+    // large enough for the sweeps to be split across the worker threads
+    const std::size_t nqubits = 17U;
+    ec::DenseState    serial(nqubits, 1U);
+    ec::DenseState    parallel(nqubits, 4U);
+    for (std::size_t q = 0U; q < nqubits; ++q) {
+        const auto angle = 0.1 * static_cast<double>(q + 1U);
+        const auto ry    = ec::DenseState::Matrix{std::cos(angle), -std::sin(angle), std::sin(angle), std::cos(angle)};
+        serial.apply(ry, {q});
+        parallel.apply(ry, {q});
+    }
+    const auto cx = ec::DenseState::Matrix{0., 1., 1., 0.};
+    for (std::size_t q = 1U; q < nqubits; ++q) {
+        serial.apply(cx, {q}, {q - 1U});
+        parallel.apply(cx, {q}, {q - 1U});
+    }
+    EXPECT_NEAR(parallel.fidelity(serial), 1., 1e-10);
+    EXPECT_NEAR(serial.fidelity(serial), 1., 1e-10);
+}
+
+TEST_F(SimulationTest, DenseBackend) {
+    for (const auto* file: {"./circuits/test/test_alternative.real", "./circuits/test/test_erroneous.real"}) {
+        qc::QuantumComputation original("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative(file);
+        qc::QuantumComputation original2("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative2(file);
+
+        config.stimuliType       = ec::StimuliType::LocalQuantum;
+        config.simulationBackend = ec::SimulationBackend::DecisionDiagram;
+        ec::SimulationBasedEquivalenceChecker ddChecker(original, alternative, 12345);
+        const auto                            ddResults = ddChecker.check(config);
+
+        config.simulationBackend = ec::SimulationBackend::Dense;
+        ec::SimulationBasedEquivalenceChecker denseChecker(original2, alternative2, 12345);
+        const auto                            denseResults = denseChecker.check(config);
+        denseResults.print();
+
+        EXPECT_EQ(denseResults.equivalence, ddResults.equivalence);
+        EXPECT_EQ(denseResults.nsims, ddResults.nsims);
+        EXPECT_NEAR(denseResults.fidelity, ddResults.fidelity, 1e-8);
+        EXPECT_EQ(denseResults.cexInput.size(), ddResults.cexInput.size());
+        EXPECT_EQ(denseResults.circuit1.cexOutput.size(), ddResults.circuit1.cexOutput.size());
+    }
+}
+
+TEST_F(SimulationTest, AdaptiveBackend) {
+    for (const auto* file: {"./circuits/test/test_alternative.real", "./circuits/test/test_erroneous.real"}) {
+        qc::QuantumComputation original("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative(file);
+        qc::QuantumComputation original2("./circuits/test/test_original.real");
+        qc::QuantumComputation alternative2(file);
+
+        config.stimuliType       = ec::StimuliType::LocalQuantum;
+        config.simulationBackend = ec::SimulationBackend::DecisionDiagram;
+        ec::SimulationBasedEquivalenceChecker ddChecker(original, alternative, 12345);
+        const auto                            ddResults = ddChecker.check(config);
+
+        // switch to dense states right after the first gate
+        config.simulationBackend    = ec::SimulationBackend::Adaptive;
+        config.denseSwitchThreshold = 0.;
+        ec::SimulationBasedEquivalenceChecker adaptiveChecker(original2, alternative2, 12345);
+        const auto                            adaptiveResults = adaptiveChecker.check(config);
+        adaptiveResults.print();
+
+        EXPECT_EQ(adaptiveResults.equivalence, ddResults.equivalence);
+        EXPECT_EQ(adaptiveResults.nsims, ddResults.nsims);
+        EXPECT_NEAR(adaptiveResults.fidelity, ddResults.fidelity, 1e-8);
+        EXPECT_GT(adaptiveResults.denseSwitches, 0U);
+        EXPECT_EQ(adaptiveResults.denseSwitchGate, 0U);
+        EXPECT_GT(adaptiveResults.peakStateMemory, 0U);
+        EXPECT_TRUE(adaptiveResults.produceJSON()["statistics"].contains("adaptive_backend"));
+    }
+}
+
+TEST_F(SimulationTest, DenseBackendModes) {
+    config.simulationBackend = ec::SimulationBackend::Dense;
+    config.max_sims          = 64;
+
+    // every stimulus loop simulates with the dense backend
+    config.adaptiveStimuli = true;
+    qc::QuantumComputation                original("./circuits/test/test_original.real");
+    qc::QuantumComputation                alternative("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker adaptive(original, alternative, 12345);
+    const auto                            adaptiveResults = adaptive.check(config);
+    EXPECT_TRUE(adaptiveResults.consideredEquivalent());
+    config.adaptiveStimuli = false;
+
+    config.estimateFidelity = true;
+    config.stimuliType      = ec::StimuliType::GlobalQuantum;
+    qc::QuantumComputation                original2("./circuits/test/test_original.real");
+    qc::QuantumComputation                erroneous("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker estimate(original2, erroneous, 12345);
+    const auto                            estimateResults = estimate.check(config);
+    EXPECT_TRUE(estimateResults.fidelityEstimated);
+    EXPECT_EQ(estimateResults.equivalence, ec::Equivalence::NotEquivalent);
+    config.estimateFidelity = false;
+
+    config.stimuliType                 = ec::StimuliType::LocalQuantum;
+    config.concurrentCircuitSimulation = true;
+    qc::QuantumComputation                original3("./circuits/test/test_original.real");
+    qc::QuantumComputation                erroneous2("./circuits/test/test_erroneous.real");
+    ec::SimulationBasedEquivalenceChecker concurrent(original3, erroneous2, 12345);
+    EXPECT_EQ(concurrent.check(config).equivalence, ec::Equivalence::NotEquivalent);
+    config.concurrentCircuitSimulation = false;
+
+    // modes that only support decision diagrams reject the dense backend
+    config.nthreads = 4;
+    qc::QuantumComputation                original4("./circuits/test/test_original.real");
+    qc::QuantumComputation                alternative2("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker parallel(original4, alternative2, 12345);
+    EXPECT_THROW(parallel.check(config), std::invalid_argument);
+    config.nthreads = 1;
+
+    qc::QuantumComputation reference("./circuits/test/test_original.real");
+    qc::QuantumComputation candidate("./circuits/test/test_alternative.real");
+    EXPECT_THROW(ec::SimulationBasedEquivalenceChecker::checkCandidates(reference, {candidate}, config, 12345), std::invalid_argument);
+
+    config.approximationNodeBudget = 8;
+    qc::QuantumComputation                original5("./circuits/test/test_original.real");
+    qc::QuantumComputation                alternative3("./circuits/test/test_alternative.real");
+    ec::SimulationBasedEquivalenceChecker approximate(original5, alternative3, 12345);
+    EXPECT_THROW(approximate.check(config), std::invalid_argument);
+}
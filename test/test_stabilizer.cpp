@@ -0,0 +1,196 @@
+/*
+ * This file is part of JKQ QCEC library which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_verification/ for more information.
+ */
+
+#include "ImprovedDDEquivalenceChecker.hpp"
+#include "StabilizerEquivalenceChecker.hpp"
+#include "StabilizerTableau.hpp"
+
+#include "gtest/gtest.h"
+#include <random>
+
+class StabilizerTest: public ::testing::Test {
+protected:
+    dd::QubitCount         nqubits = 3;
+    qc::QuantumComputation qc_original{nqubits};
+    qc::QuantumComputation qc_alternative{nqubits};
+    ec::Configuration      config{};
+};
+
+TEST_F(StabilizerTest, EquivalentCliffordCircuits) {
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 2, qc::S);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, dd::Control{1}, 2, qc::Z);
+
+    // CNOT realized by a CZ in the Hadamard basis, S realized by a rotation
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 1, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, dd::Control{0}, 1, qc::Z);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 1, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 2, qc::RZ, dd::PI_2);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, dd::Control{2}, 1, qc::Z);
+
+    ec::StabilizerEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.print();
+    EXPECT_EQ(results.method, ec::Method::Stabilizer);
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_F(StabilizerTest, NonEquivalentCliffordCircuits) {
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 0, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 0, qc::S);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, dd::Control{0}, 1, qc::X);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 2, qc::X);
+
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::Sdag);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, dd::Control{0}, 1, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 2, qc::X);
+
+    ec::StabilizerEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.print();
+    EXPECT_EQ(results.method, ec::Method::Stabilizer);
+    EXPECT_EQ(results.equivalence, ec::Equivalence::NotEquivalent);
+}
+
+TEST_F(StabilizerTest, OutputPermutation) {
+    // SWAP of qubits 0 and 1 decomposed into CNOTs versus a relabeling of the outputs
+    for (dd::Qubit i = 0; i < 3; ++i) {
+        qc_original.emplace_back<qc::StandardOperation>(nqubits, dd::Control{static_cast<dd::Qubit>(i % 2)}, static_cast<dd::Qubit>(1 - i % 2), qc::X);
+    }
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 2, qc::H);
+
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::X);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 1, qc::Y);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 1, qc::Y);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 2, qc::H);
+    qc_alternative.outputPermutation[0] = 1;
+    qc_alternative.outputPermutation[1] = 0;
+
+    config.reconstructSWAPs = false;
+    ec::StabilizerEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.print();
+    EXPECT_EQ(results.method, ec::Method::Stabilizer);
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_F(StabilizerTest, NonCliffordFallback) {
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 0, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 0, qc::T);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 1, qc::H);
+    qc_original.emplace_back<qc::StandardOperation>(nqubits, 2, qc::X);
+
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 0, qc::S);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 1, qc::H);
+    qc_alternative.emplace_back<qc::StandardOperation>(nqubits, 2, qc::X);
+
+    ec::StabilizerEquivalenceChecker ec(qc_original, qc_alternative);
+    auto                             results = ec.check(config);
+    results.print();
+    EXPECT_EQ(results.method, ec::Method::G_I_Gp);
+    EXPECT_TRUE(results.consideredEquivalent());
+}
+
+TEST_F(StabilizerTest, AgreesWithDecisionDiagrams) {
+    std::mt19937_64 mt(42);
+    for (std::size_t trial = 0U; trial < 20U; ++trial) {
+        qc::QuantumComputation circ1(nqubits);
+        qc::QuantumComputation circ2(nqubits);
+        for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+            circ1.emplace_back<qc::StandardOperation>(nqubits, q, qc::H);
+            circ2.emplace_back<qc::StandardOperation>(nqubits, q, qc::H);
+        }
+        for (auto* circ: {&circ1, &circ2}) {
+            for (std::size_t g = 0U; g < 6U; ++g) {
+                const auto q = static_cast<dd::Qubit>(mt() % nqubits);
+                switch (mt() % 4U) {
+                    case 0:
+                        circ->emplace_back<qc::StandardOperation>(nqubits, q, qc::H);
+                        break;
+                    case 1:
+                        circ->emplace_back<qc::StandardOperation>(nqubits, q, qc::S);
+                        break;
+                    case 2:
+                        circ->emplace_back<qc::StandardOperation>(nqubits, q, qc::SX);
+                        break;
+                    default:
+                        circ->emplace_back<qc::StandardOperation>(nqubits, dd::Control{q}, static_cast<dd::Qubit>((q + 1) % nqubits), qc::X);
+                }
+            }
+        }
+        qc::QuantumComputation dd1(nqubits);
+        qc::QuantumComputation dd2(nqubits);
+        for (const auto& op: circ1) {
+            dd1.emplace_back(op->clone());
+        }
+        for (const auto& op: circ2) {
+            dd2.emplace_back(op->clone());
+        }
+
+        ec::StabilizerEquivalenceChecker stabilizer(circ1, circ2);
+        ec::ImprovedDDEquivalenceChecker reference(dd1, dd2);
+        EXPECT_EQ(stabilizer.check(config).consideredEquivalent(), reference.check(config).consideredEquivalent());
+    }
+}
+
+TEST_F(StabilizerTest, TableauToVectorDD) {
+    constexpr dd::QubitCount n = 5;
+    auto                     dd = std::make_unique<dd::Package>(n);
+    std::mt19937_64          mt(1337);
+    for (std::size_t trial = 0U; trial < 20U; ++trial) {
+        qc::QuantumComputation circ(n);
+        for (std::size_t g = 0U; g < 20U; ++g) {
+            const auto q = static_cast<dd::Qubit>(mt() % n);
+            const auto t = static_cast<dd::Qubit>((q + 1 + mt() % (n - 1)) % n);
+            switch (mt() % 6U) {
+                case 0:
+                    circ.emplace_back<qc::StandardOperation>(n, q, qc::H);
+                    break;
+                case 1:
+                    circ.emplace_back<qc::StandardOperation>(n, q, qc::S);
+                    break;
+                case 2:
+                    circ.emplace_back<qc::StandardOperation>(n, q, qc::SX);
+                    break;
+                case 3:
+                    circ.emplace_back<qc::StandardOperation>(n, q, qc::Y);
+                    break;
+                case 4:
+                    circ.emplace_back<qc::StandardOperation>(n, dd::Control{q}, t, qc::Z);
+                    break;
+                default:
+                    circ.emplace_back<qc::StandardOperation>(n, dd::Control{q}, t, qc::X);
+            }
+        }
+
+        auto            tableau     = ec::StabilizerTableau::zeroState(n);
+        qc::Permutation permutation = circ.initialLayout;
+        for (const auto& op: circ) {
+            tableau.apply(*op, permutation);
+        }
+        const auto state    = tableau.toVectorDD(dd);
+        const auto expected = circ.simulate(dd->makeZeroState(n), dd);
+        EXPECT_NEAR(dd->innerProduct(state, state).r, 1., 1e-8);
+        EXPECT_NEAR(dd->fidelity(state, expected), 1., 1e-8);
+    }
+}
+
+TEST_F(StabilizerTest, RandomStabilizerStates) {
+    constexpr dd::QubitCount n = 6;
+    auto                     dd = std::make_unique<dd::Package>(n);
+    std::mt19937_64          mt(42);
+    for (std::size_t trial = 0U; trial < 20U; ++trial) {
+        auto tableau = ec::StabilizerTableau::zeroState(n);
+        // the last qubit is not randomized and has to remain in the |0> state
+        tableau.randomize(n - 1, 3U, mt);
+        const auto state = tableau.toVectorDD(dd);
+        EXPECT_NEAR(dd->innerProduct(state, state).r, 1., 1e-8);
+        EXPECT_TRUE(state.p->e[1].w.approximatelyZero());
+    }
+}